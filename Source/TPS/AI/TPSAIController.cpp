@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAIController.h"
+#include "TPSAIPlayerState.h"
+#include "TPSBotSubsystem.h"
+#include "TPSCharacter.h"
+#include "TPS.h"
+#include "AbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+ATPSAIController::ATPSAIController()
+{
+	// The ASC lives on the PlayerState, same as for players
+	bWantsPlayerState = true;
+}
+
+void ATPSAIController::InitPlayerState()
+{
+	if (GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.Owner = this;
+	SpawnInfo.Instigator = GetInstigator();
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// Player states are never saved into a map
+	SpawnInfo.ObjectFlags |= RF_Transient;
+
+	ATPSAIPlayerState* BotPlayerState = GetWorld()->SpawnActor<ATPSAIPlayerState>(ATPSAIPlayerState::StaticClass(), SpawnInfo);
+	if (BotPlayerState)
+	{
+		BotPlayerState->SetIsABot(true);
+		BotPlayerState->SetPlayerName(FString::Printf(TEXT("Bot_%d"), BotPlayerState->GetPlayerId()));
+		SetPlayerState(BotPlayerState);
+	}
+}
+
+void ATPSAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	if (UTPSBotSubsystem* BotSubsystem = GetWorld()->GetSubsystem<UTPSBotSubsystem>())
+	{
+		BotSubsystem->RegisterBot(this);
+	}
+
+	SetStreamingSourceRegistered(true);
+}
+
+void ATPSAIController::OnUnPossess()
+{
+	SetFiring(false);
+
+	if (UTPSBotSubsystem* BotSubsystem = GetWorld()->GetSubsystem<UTPSBotSubsystem>())
+	{
+		BotSubsystem->UnregisterBot(this);
+	}
+
+	SetStreamingSourceRegistered(false);
+
+	Super::OnUnPossess();
+}
+
+void ATPSAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetStreamingSourceRegistered(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool ATPSAIController::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
+{
+	const APawn* BotPawn = GetPawn();
+	if (!BotPawn)
+	{
+		return false;
+	}
+
+	FWorldPartitionStreamingSource& Source = OutStreamingSources.AddDefaulted_GetRef();
+	Source.Name = GetFName();
+	Source.Location = BotPawn->GetActorLocation();
+	Source.Rotation = GetControlRotation();
+	Source.TargetState = EStreamingSourceTargetState::Activated;
+	Source.Priority = EStreamingSourcePriority::Low;
+
+	FStreamingSourceShape& Shape = Source.Shapes.AddDefaulted_GetRef();
+	Shape.bUseGridLoadingRange = false;
+	Shape.Radius = ServerStreamingRadius;
+	return true;
+}
+
+void ATPSAIController::SetStreamingSourceRegistered(bool bRegister)
+{
+	// Players stream the world on clients, bots only matter to a dedicated server that streams cells out
+	if (bRegister && (GetNetMode() != NM_DedicatedServer || ServerStreamingRadius <= 0.0f))
+	{
+		return;
+	}
+
+	UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UWorldPartitionSubsystem>() : nullptr;
+	if (!WorldPartitionSubsystem || bStreamingSourceRegistered == bRegister)
+	{
+		return;
+	}
+
+	if (bRegister)
+	{
+		WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+	}
+	else
+	{
+		WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+	}
+	bStreamingSourceRegistered = bRegister;
+}
+
+void ATPSAIController::SetCandidateTarget(ATPSCharacter* Target)
+{
+	CandidateTarget = Target;
+}
+
+void ATPSAIController::SetVisibleTarget(ATPSCharacter* Target)
+{
+	VisibleTarget = Target;
+}
+
+void ATPSAIController::Think()
+{
+	ATPSCharacter* Bot = GetPawn<ATPSCharacter>();
+	if (!Bot || !Bot->IsAlive())
+	{
+		SetFiring(false);
+		return;
+	}
+
+	ATPSCharacter* Target = VisibleTarget.Get();
+	if (Target && Target->IsAlive())
+	{
+		SetFocus(Target);
+
+		if (FVector::DistSquared(Bot->GetActorLocation(), Target->GetActorLocation()) > FMath::Square(EngageDistance))
+		{
+			MoveToActor(Target, EngageDistance * 0.8f);
+		}
+		else
+		{
+			StopMovement();
+		}
+
+		SetFiring(true);
+		return;
+	}
+
+	SetFiring(false);
+	ClearFocus(EAIFocusPriority::Gameplay);
+
+	// Close in on whoever is nearest until the line of sight check says it is visible
+	if (ATPSCharacter* Candidate = CandidateTarget.Get())
+	{
+		MoveToActor(Candidate, EngageDistance * 0.8f);
+	}
+}
+
+void ATPSAIController::SetFiring(bool bFire)
+{
+	if (bFiring == bFire)
+	{
+		return;
+	}
+
+	ATPSCharacter* Bot = GetPawn<ATPSCharacter>();
+	UAbilitySystemComponent* AbilitySystemComponent = Bot ? Bot->GetAbilitySystemComponent() : nullptr;
+	if (!AbilitySystemComponent)
+	{
+		bFiring = false;
+		return;
+	}
+
+	// Same input IDs the player's Fire action sends, so abilities don't need to know about bots
+	if (bFire)
+	{
+		AbilitySystemComponent->AbilityLocalInputPressed(static_cast<int32>(EAbilityInputID::Fire));
+	}
+	else
+	{
+		AbilitySystemComponent->AbilityLocalInputReleased(static_cast<int32>(EAbilityInputID::Fire));
+	}
+
+	bFiring = bFire;
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "TPSAIController.generated.h"
+
+class ATPSCharacter;
+
+/**
+ * Server-side bot. Owns a lightweight ATPSAIPlayerState so the possessed ATPSCharacter gets its ASC, attributes
+ * and abilities through the same PossessedBy path as players, and fires through the ability input IDs.
+ * Perception and decisions are driven in time slices by UTPSBotSubsystem, the controller does no per-frame work itself.
+ * On dedicated servers each bot is a World Partition streaming source like a player, so bots far from every player
+ * keep the collision under their feet when server streaming unloads cells.
+ */
+UCLASS()
+class TPS_API ATPSAIController : public AAIController, public IWorldPartitionStreamingSourceProvider
+{
+	GENERATED_BODY()
+
+public:
+	ATPSAIController();
+
+	// Targets further than this are ignored
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bot")
+	float SightRadius = 5000.0f;
+
+	// The bot stops moving closer once a visible target is within this distance
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bot")
+	float EngageDistance = 1500.0f;
+
+	// World Partition cells a dedicated server keeps loaded around each bot, same as ATPSPlayerController::ServerStreamingRadius
+	UPROPERTY(EditDefaultsOnly, Category = "WorldPartition")
+	float ServerStreamingRadius = 10000.0f;
+
+	virtual void InitPlayerState() override;
+
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+	virtual const UObject* GetStreamingSourceOwner() const override { return this; }
+
+	// Called by UTPSBotSubsystem in a time slice
+	void Think();
+
+	// Called by UTPSBotSubsystem when the line of sight trace towards CandidateTarget returns
+	void SetVisibleTarget(ATPSCharacter* Target);
+
+	void SetCandidateTarget(ATPSCharacter* Target);
+
+	ATPSCharacter* GetCandidateTarget() const { return CandidateTarget.Get(); }
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void SetFiring(bool bFire);
+
+	void SetStreamingSourceRegistered(bool bRegister);
+
+	TWeakObjectPtr<ATPSCharacter> CandidateTarget;
+
+	TWeakObjectPtr<ATPSCharacter> VisibleTarget;
+
+	bool bFiring = false;
+
+	bool bStreamingSourceRegistered = false;
+};
@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAIPlayerState.h"
+#include "AbilitySystemComponent.h"
+
+ATPSAIPlayerState::ATPSAIPlayerState()
+{
+	GetAbilitySystemComponent()->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
+
+	AdaptiveNetUpdate.MaxFrequency = 10.0f;
+	AdaptiveNetUpdate.MinFrequency = 1.0f;
+	NetUpdateFrequency = AdaptiveNetUpdate.MaxFrequency;
+}
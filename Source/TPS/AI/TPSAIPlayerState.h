@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TPSPlayerState.h"
+#include "TPSAIPlayerState.generated.h"
+
+/**
+ * Lightweight ASC owner for bots. Same ASC and attribute set as players so abilities and effects work unchanged,
+ * but with minimal effect replication and a low update rate since nobody predicts for a bot.
+ */
+UCLASS()
+class TPS_API ATPSAIPlayerState : public ATPSPlayerState
+{
+	GENERATED_BODY()
+
+public:
+	ATPSAIPlayerState();
+};
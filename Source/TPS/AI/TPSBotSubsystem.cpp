@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSBotSubsystem.h"
+#include "TPSAIController.h"
+#include "TPSCharacter.h"
+#include "GameFramework/GameModeBase.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TPSStats.h"
+
+namespace TPSBots
+{
+	static int32 BotsPerFrame = 10;
+	static FAutoConsoleVariableRef CVarBotsPerFrame(
+		TEXT("tps.AI.BotsPerFrame"),
+		BotsPerFrame,
+		TEXT("Number of bots that update perception and think each frame."));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdSpawnBots(
+		TEXT("tps.AI.SpawnBots"),
+		TEXT("Spawns bots at player starts. Usage: tps.AI.SpawnBots [NumBots=1]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UTPSBotSubsystem* BotSubsystem = World ? World->GetSubsystem<UTPSBotSubsystem>() : nullptr)
+			{
+				BotSubsystem->SpawnBots(Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1);
+			}
+		}));
+}
+
+bool UTPSBotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UTPSBotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTPSBotSubsystem, STATGROUP_Tickables);
+}
+
+void UTPSBotSubsystem::RegisterBot(ATPSAIController* Bot)
+{
+	Bots.AddUnique(Bot);
+}
+
+void UTPSBotSubsystem::UnregisterBot(ATPSAIController* Bot)
+{
+	Bots.Remove(Bot);
+}
+
+void UTPSBotSubsystem::Tick(float DeltaTime)
+{
+	Bots.RemoveAll([](const TWeakObjectPtr<ATPSAIController>& Bot) { return !Bot.IsValid(); });
+	if (Bots.Num() == 0)
+	{
+		return;
+	}
+
+	TPS_SCOPE_CYCLE_COUNTER(Bots);
+
+	AliveCharacters.Reset();
+	for (TActorIterator<ATPSCharacter> It(GetWorld()); It; ++It)
+	{
+		if (It->IsAlive())
+		{
+			AliveCharacters.Add(*It);
+		}
+	}
+
+	const int32 NumToUpdate = FMath::Min(FMath::Max(TPSBots::BotsPerFrame, 1), Bots.Num());
+	for (int32 Count = 0; Count < NumToUpdate; ++Count)
+	{
+		NextBotIndex = NextBotIndex % Bots.Num();
+		ATPSAIController* Bot = Bots[NextBotIndex++].Get();
+
+		UpdatePerception(Bot);
+		Bot->Think();
+	}
+}
+
+void UTPSBotSubsystem::UpdatePerception(ATPSAIController* Bot)
+{
+	const APawn* BotPawn = Bot->GetPawn();
+	if (!BotPawn)
+	{
+		Bot->SetCandidateTarget(nullptr);
+		Bot->SetVisibleTarget(nullptr);
+		return;
+	}
+
+	const FVector BotLocation = BotPawn->GetActorLocation();
+	float BestDistanceSquared = FMath::Square(Bot->SightRadius);
+	ATPSCharacter* BestTarget = nullptr;
+	for (ATPSCharacter* Character : AliveCharacters)
+	{
+		const float DistanceSquared = FVector::DistSquared(BotLocation, Character->GetActorLocation());
+		if (Character != BotPawn && DistanceSquared < BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			BestTarget = Character;
+		}
+	}
+
+	Bot->SetCandidateTarget(BestTarget);
+	if (!BestTarget)
+	{
+		Bot->SetVisibleTarget(nullptr);
+		return;
+	}
+
+	// Async traces of the whole slice run together on worker threads, the result is read on a later think
+	FVector EyeLocation;
+	FRotator EyeRotation;
+	BotPawn->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TPSBotLineOfSight), false, BotPawn);
+	FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(this, &UTPSBotSubsystem::OnLineOfSightTraceDone,
+		TWeakObjectPtr<ATPSAIController>(Bot), TWeakObjectPtr<ATPSCharacter>(BestTarget));
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, EyeLocation, BestTarget->GetActorLocation(), ECC_Visibility,
+		QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate);
+}
+
+void UTPSBotSubsystem::OnLineOfSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, TWeakObjectPtr<ATPSAIController> Bot, TWeakObjectPtr<ATPSCharacter> Target)
+{
+	if (!Bot.IsValid())
+	{
+		return;
+	}
+
+	const bool bBlocked = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit && TraceDatum.OutHits[0].GetActor() != Target.Get();
+	Bot->SetVisibleTarget(bBlocked ? nullptr : Target.Get());
+}
+
+void UTPSBotSubsystem::SpawnBots(int32 NumBots)
+{
+	UWorld* World = GetWorld();
+	AGameModeBase* GameMode = World->GetAuthGameMode();
+	if (!GameMode || !GameMode->DefaultPawnClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s() No game mode or default pawn class to spawn bots with"), *FString(__FUNCTION__));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < NumBots; ++Index)
+	{
+		ATPSAIController* Bot = World->SpawnActor<ATPSAIController>(ATPSAIController::StaticClass(), SpawnParameters);
+		if (!Bot)
+		{
+			continue;
+		}
+
+		const AActor* PlayerStart = GameMode->FindPlayerStart(Bot);
+		const FTransform SpawnTransform = PlayerStart ? PlayerStart->GetActorTransform() : FTransform::Identity;
+
+		APawn* Pawn = World->SpawnActor<APawn>(GameMode->DefaultPawnClass, SpawnTransform, SpawnParameters);
+		if (!Pawn)
+		{
+			Bot->Destroy();
+			continue;
+		}
+
+		Bot->Possess(Pawn);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s() %d bots active"), *FString(__FUNCTION__), Bots.Num());
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "TPSBotSubsystem.generated.h"
+
+class ATPSAIController;
+class ATPSCharacter;
+
+/**
+ * Shared perception and decision scheduler for every bot on the server.
+ * Each frame a slice of bots (tps.AI.BotsPerFrame) picks its nearest target, queues an async line of sight trace
+ * and thinks with the last trace result, so the per-frame cost stays flat as bots are added.
+ */
+UCLASS()
+class TPS_API UTPSBotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterBot(ATPSAIController* Bot);
+
+	void UnregisterBot(ATPSAIController* Bot);
+
+	// Spawns NumBots default pawns at player starts, each possessed by an ATPSAIController
+	void SpawnBots(int32 NumBots);
+
+	int32 GetNumBots() const { return Bots.Num(); }
+
+private:
+	void UpdatePerception(ATPSAIController* Bot);
+
+	void OnLineOfSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, TWeakObjectPtr<ATPSAIController> Bot, TWeakObjectPtr<ATPSCharacter> Target);
+
+	TArray<TWeakObjectPtr<ATPSAIController>> Bots;
+
+	// Alive characters gathered once per frame and shared by every bot in the slice
+	TArray<ATPSCharacter*> AliveCharacters;
+
+	int32 NextBotIndex = 0;
+};
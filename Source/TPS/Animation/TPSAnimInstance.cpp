@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAnimInstance.h"
+#include "TPSCharacter.h"
+#include "TPSCharacterMovementComponent.h"
+#include "AbilitySystemComponent.h"
+
+void UTPSAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	AimDownSightTag = FGameplayTag::RequestGameplayTag(FName("State.AimDownSight"));
+
+	Character = Cast<ATPSCharacter>(TryGetPawnOwner());
+	if (Character)
+	{
+		MovementComponent = Cast<UTPSCharacterMovementComponent>(Character->GetCharacterMovement());
+	}
+
+	BindToAbilitySystem();
+}
+
+void UTPSAnimInstance::NativeUninitializeAnimation()
+{
+	if (BoundAbilitySystemComponent.IsValid())
+	{
+		BoundAbilitySystemComponent->RegisterGameplayTagEvent(AimDownSightTag, EGameplayTagEventType::NewOrRemoved).Remove(AimDownSightTagHandle);
+	}
+	BoundAbilitySystemComponent.Reset();
+
+	Super::NativeUninitializeAnimation();
+}
+
+void UTPSAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	if (!Character || !MovementComponent)
+	{
+		return;
+	}
+
+	// The ASC lives on the PlayerState and may arrive after the anim instance is initialized
+	if (!BoundAbilitySystemComponent.IsValid())
+	{
+		BindToAbilitySystem();
+	}
+
+	// Copy only, anything derived from these values is computed on the worker thread
+	GatheredVelocity = MovementComponent->Velocity;
+	GatheredAimRotation = Character->GetBaseAimRotation();
+	GatheredActorRotation = Character->GetActorRotation();
+	bGatheredIsFalling = MovementComponent->IsFalling();
+	bGatheredRequestToStartSprinting = MovementComponent->RequestToStartSprinting;
+	bGatheredRequestToStartADS = MovementComponent->RequestToStartADS;
+	bGatheredAimDownSight = bAimDownSightTagPresent;
+}
+
+void UTPSAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	State.Velocity = GatheredVelocity;
+	State.GroundSpeed = GatheredVelocity.Size2D();
+	State.bIsFalling = bGatheredIsFalling;
+	State.bShouldMove = State.GroundSpeed > ShouldMoveSpeedThreshold;
+	State.bRequestToStartSprinting = bGatheredRequestToStartSprinting;
+	State.bRequestToStartADS = bGatheredRequestToStartADS;
+	State.bAimDownSight = bGatheredAimDownSight;
+
+	const FRotator AimDelta = (GatheredAimRotation - GatheredActorRotation).GetNormalized();
+	State.AimPitch = AimDelta.Pitch;
+	State.AimYaw = AimDelta.Yaw;
+}
+
+void UTPSAnimInstance::BindToAbilitySystem()
+{
+	if (!Character)
+	{
+		return;
+	}
+
+	UAbilitySystemComponent* AbilitySystemComponent = Character->GetAbilitySystemComponent();
+	if (!AbilitySystemComponent)
+	{
+		return;
+	}
+
+	BoundAbilitySystemComponent = AbilitySystemComponent;
+	AimDownSightTagHandle = AbilitySystemComponent->RegisterGameplayTagEvent(AimDownSightTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &UTPSAnimInstance::OnAimDownSightTagChanged);
+	bAimDownSightTagPresent = AbilitySystemComponent->HasMatchingGameplayTag(AimDownSightTag);
+}
+
+void UTPSAnimInstance::OnAimDownSightTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bAimDownSightTagPresent = NewCount > 0;
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "GameplayTagContainer.h"
+#include "TPSAnimInstance.generated.h"
+
+class ATPSCharacter;
+class UTPSCharacterMovementComponent;
+class UAbilitySystemComponent;
+
+/**
+ * Movement and ability state consumed by the hero anim graph.
+ * Only touched by the anim worker thread once gathered, so the graph can read it from thread-safe functions.
+ */
+USTRUCT(BlueprintType)
+struct FTPSAnimStateSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	FVector Velocity = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	float GroundSpeed = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	bool bIsFalling = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	bool bShouldMove = false;
+
+	// Mirrors UTPSCharacterMovementComponent::RequestToStartSprinting
+	UPROPERTY(BlueprintReadOnly, Category = "Sprint")
+	bool bRequestToStartSprinting = false;
+
+	// Mirrors UTPSCharacterMovementComponent::RequestToStartADS
+	UPROPERTY(BlueprintReadOnly, Category = "Aim Down Sights")
+	bool bRequestToStartADS = false;
+
+	// True while the State.AimDownSight tag is present on the ASC
+	UPROPERTY(BlueprintReadOnly, Category = "Aim Down Sights")
+	bool bAimDownSight = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Aim")
+	float AimPitch = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Aim")
+	float AimYaw = 0.0f;
+};
+
+/**
+ * Native base for the hero anim blueprints (ABP_Hero, UE4ASP_HeroTPP_AnimBlueprint).
+ * The game thread only copies a handful of raw values, everything derived from them is computed
+ * in NativeThreadSafeUpdateAnimation so the graph can run entirely on the fast path.
+ */
+UCLASS()
+class TPS_API UTPSAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "State")
+	FTPSAnimStateSnapshot State;
+
+	// Minimal ground speed for the locomotion state machine to leave idle
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement")
+	float ShouldMoveSpeedThreshold = 3.0f;
+
+protected:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeUninitializeAnimation() override;
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
+private:
+	void BindToAbilitySystem();
+
+	void OnAimDownSightTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	UPROPERTY(Transient)
+	TObjectPtr<ATPSCharacter> Character;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UTPSCharacterMovementComponent> MovementComponent;
+
+	TWeakObjectPtr<UAbilitySystemComponent> BoundAbilitySystemComponent;
+
+	FDelegateHandle AimDownSightTagHandle;
+
+	FGameplayTag AimDownSightTag;
+
+	// Written by the tag event on the game thread, the worker only sees the copy in bGatheredAimDownSight
+	bool bAimDownSightTagPresent = false;
+
+	// Raw values copied on the game thread in NativeUpdateAnimation
+	FVector GatheredVelocity = FVector::ZeroVector;
+	FRotator GatheredAimRotation = FRotator::ZeroRotator;
+	FRotator GatheredActorRotation = FRotator::ZeroRotator;
+	bool bGatheredIsFalling = false;
+	bool bGatheredRequestToStartSprinting = false;
+	bool bGatheredRequestToStartADS = false;
+	bool bGatheredAimDownSight = false;
+};
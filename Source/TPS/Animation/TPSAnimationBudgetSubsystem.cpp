@@ -0,0 +1,313 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAnimationBudgetSubsystem.h"
+#include "TPSCharacter.h"
+#include "Significance/TPSSignificanceManager.h"
+#include "IAnimationBudgetAllocator.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "GameFramework/GameModeBase.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+DECLARE_STATS_GROUP(TEXT("TPSAnimBudget"), STATGROUP_TPSAnimBudget, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enabled"), STAT_TPSAnimBudget_Enabled, STATGROUP_TPSAnimBudget);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Budget (ms)"), STAT_TPSAnimBudget_BudgetMs, STATGROUP_TPSAnimBudget);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Budgeted characters"), STAT_TPSAnimBudget_Characters, STATGROUP_TPSAnimBudget);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game thread (ms)"), STAT_TPSAnimBudget_GameThreadMs, STATGROUP_TPSAnimBudget);
+
+namespace TPSAnimBudget
+{
+	static void OnSettingChanged(IConsoleVariable* Variable);
+
+	static int32 Enabled = 0;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("tps.AnimBudget.Enabled"),
+		Enabled,
+		TEXT("Spread a fixed per-frame animation budget across TPS characters by significance (0: off, 1: on)."),
+		FConsoleVariableDelegate::CreateStatic(&OnSettingChanged));
+
+	static float BudgetMs = 1.0f;
+	static FAutoConsoleVariableRef CVarBudgetMs(
+		TEXT("tps.AnimBudget.BudgetMs"),
+		BudgetMs,
+		TEXT("Game thread time in milliseconds allowed for skeletal mesh animation per frame."),
+		FConsoleVariableDelegate::CreateStatic(&OnSettingChanged));
+
+	static float MinQuality = 0.0f;
+	static FAutoConsoleVariableRef CVarMinQuality(
+		TEXT("tps.AnimBudget.MinQuality"),
+		MinQuality,
+		TEXT("Lowest quality (0-1) a budgeted character can be reduced to. 0 lets low significance meshes skip updates entirely."),
+		FConsoleVariableDelegate::CreateStatic(&OnSettingChanged));
+
+	static int32 MaxTickRate = 10;
+	static FAutoConsoleVariableRef CVarMaxTickRate(
+		TEXT("tps.AnimBudget.MaxTickRate"),
+		MaxTickRate,
+		TEXT("Largest number of frames a low significance mesh may skip between updates."),
+		FConsoleVariableDelegate::CreateStatic(&OnSettingChanged));
+
+	static int32 MaxInterpolatedComponents = 32;
+	static FAutoConsoleVariableRef CVarMaxInterpolatedComponents(
+		TEXT("tps.AnimBudget.MaxInterpolatedComponents"),
+		MaxInterpolatedComponents,
+		TEXT("Largest number of meshes interpolated between skipped updates."),
+		FConsoleVariableDelegate::CreateStatic(&OnSettingChanged));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdBenchmark(
+		TEXT("tps.AnimBudget.Benchmark"),
+		TEXT("Spawns characters and logs game thread time with animation budgeting off and on. Usage: tps.AnimBudget.Benchmark [NumCharacters=100] [FramesPerPhase=300]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UTPSAnimationBudgetSubsystem* Subsystem = World ? World->GetSubsystem<UTPSAnimationBudgetSubsystem>() : nullptr;
+			if (!Subsystem)
+			{
+				return;
+			}
+
+			const int32 NumCharacters = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+			const int32 FramesPerPhase = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+			Subsystem->StartBenchmark(FMath::Max(NumCharacters, 1), FMath::Max(FramesPerPhase, 1));
+		}));
+
+	static void OnSettingChanged(IConsoleVariable* Variable)
+	{
+		if (!GEngine)
+		{
+			return;
+		}
+
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (UWorld* World = Context.World())
+			{
+				if (UTPSAnimationBudgetSubsystem* Subsystem = World->GetSubsystem<UTPSAnimationBudgetSubsystem>())
+				{
+					Subsystem->ApplySettings();
+				}
+			}
+		}
+	}
+}
+
+bool UTPSAnimationBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTPSAnimationBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!USkeletalMeshComponentBudgeted::OnCalculateSignificance().IsBound())
+	{
+		USkeletalMeshComponentBudgeted::OnCalculateSignificance().BindStatic(&UTPSAnimationBudgetSubsystem::CalculateSignificance);
+	}
+}
+
+void UTPSAnimationBudgetSubsystem::Deinitialize()
+{
+	for (ACharacter* Character : BenchmarkCharacters)
+	{
+		if (IsValid(Character))
+		{
+			Character->Destroy();
+		}
+	}
+	BenchmarkCharacters.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTPSAnimationBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ApplySettings();
+}
+
+bool UTPSAnimationBudgetSubsystem::IsBudgeting(const UWorld* World)
+{
+	IAnimationBudgetAllocator* Allocator = World ? IAnimationBudgetAllocator::Get(const_cast<UWorld*>(World)) : nullptr;
+	return Allocator && Allocator->GetEnabled();
+}
+
+void UTPSAnimationBudgetSubsystem::ApplySettings()
+{
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (!Allocator)
+	{
+		return;
+	}
+
+	FAnimationBudgetAllocatorParameters Parameters;
+	Parameters.BudgetInMs = FMath::Max(TPSAnimBudget::BudgetMs, 0.1f);
+	Parameters.MinQuality = FMath::Clamp(TPSAnimBudget::MinQuality, 0.0f, 1.0f);
+	Parameters.MaxTickRate = FMath::Max(TPSAnimBudget::MaxTickRate, 1);
+	Parameters.MaxInterpolatedComponents = FMath::Max(TPSAnimBudget::MaxInterpolatedComponents, 0);
+	Allocator->SetParameters(Parameters);
+	Allocator->SetEnabled(TPSAnimBudget::Enabled != 0);
+
+	// Tiers leave the mesh alone while budgeting, so the tier rates have to be pushed again once the allocator lets go
+	if (UTPSSignificanceManager* SignificanceManager = USignificanceManager::Get<UTPSSignificanceManager>(GetWorld()))
+	{
+		SignificanceManager->ReapplyTiers();
+	}
+}
+
+float UTPSAnimationBudgetSubsystem::CalculateSignificance(USkeletalMeshComponentBudgeted* Component)
+{
+	const APawn* Pawn = Cast<APawn>(Component->GetOwner());
+	// Bots are locally controlled on listen servers, only the local player's own pawn is always full quality
+	if (!Pawn || (Pawn->IsLocallyControlled() && Pawn->IsPlayerControlled()))
+	{
+		return 1.0f;
+	}
+
+	const UTPSSignificanceManager* SignificanceManager = USignificanceManager::Get<UTPSSignificanceManager>(Pawn->GetWorld());
+	if (!SignificanceManager || SignificanceManager->Tiers.Num() == 0)
+	{
+		return 1.0f;
+	}
+
+	// Tier significance runs from Tiers.Num() (nearest) down to 1, the allocator wants 0-1
+	return FMath::Clamp(SignificanceManager->GetSignificance(Pawn) / SignificanceManager->Tiers.Num(), 0.0f, 1.0f);
+}
+
+void UTPSAnimationBudgetSubsystem::Tick(float DeltaTime)
+{
+	const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+#if STATS
+	SET_DWORD_STAT(STAT_TPSAnimBudget_Enabled, IsBudgeting(GetWorld()) ? 1 : 0);
+	SET_FLOAT_STAT(STAT_TPSAnimBudget_BudgetMs, TPSAnimBudget::BudgetMs);
+	SET_FLOAT_STAT(STAT_TPSAnimBudget_GameThreadMs, GameThreadMs);
+
+	// Counting is only worth it while the stat group is on screen or being captured
+	if (FThreadStats::IsCollectingData())
+	{
+		NumBudgetedComponents = 0;
+		for (TActorIterator<ATPSCharacter> It(GetWorld()); It; ++It)
+		{
+			if (Cast<USkeletalMeshComponentBudgeted>(It->GetMesh()))
+			{
+				++NumBudgetedComponents;
+			}
+		}
+		SET_DWORD_STAT(STAT_TPSAnimBudget_Characters, NumBudgetedComponents);
+	}
+#endif
+
+	if (BenchmarkPhase == EBenchmarkPhase::None)
+	{
+		return;
+	}
+
+	// Warmup frames let the allocator and spawned characters settle before sampling
+	if (BenchmarkPhase != EBenchmarkPhase::Warmup)
+	{
+		BenchmarkAccumulatedMs += GameThreadMs;
+	}
+
+	if (++BenchmarkFrame < BenchmarkFramesPerPhase)
+	{
+		return;
+	}
+
+	switch (BenchmarkPhase)
+	{
+	case EBenchmarkPhase::Warmup:
+		SetBenchmarkPhase(EBenchmarkPhase::Unbudgeted);
+		break;
+	case EBenchmarkPhase::Unbudgeted:
+		UnbudgetedAverageMs = BenchmarkAccumulatedMs / BenchmarkFramesPerPhase;
+		SetBenchmarkPhase(EBenchmarkPhase::Budgeted);
+		break;
+	case EBenchmarkPhase::Budgeted:
+		FinishBenchmark();
+		break;
+	default:
+		break;
+	}
+}
+
+TStatId UTPSAnimationBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTPSAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UTPSAnimationBudgetSubsystem::StartBenchmark(int32 NumCharacters, int32 FramesPerPhase)
+{
+	UWorld* World = GetWorld();
+	AGameModeBase* GameMode = World->GetAuthGameMode();
+	if (BenchmarkPhase != EBenchmarkPhase::None || !GameMode || !GameMode->DefaultPawnClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s() Benchmark needs authority, a default pawn class and no benchmark in progress"), *FString(__FUNCTION__));
+		return;
+	}
+
+	FVector Origin = FVector::ZeroVector;
+	if (APlayerController* PlayerController = World->GetFirstPlayerController())
+	{
+		if (APawn* Pawn = PlayerController->GetPawn())
+		{
+			Origin = Pawn->GetActorLocation() + Pawn->GetActorForwardVector() * 500.0f;
+		}
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 Columns = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumCharacters)));
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		const FVector Location = Origin + FVector((Index / Columns) * 200.0f, (Index % Columns) * 200.0f, 0.0f);
+		if (ACharacter* Character = World->SpawnActor<ACharacter>(GameMode->DefaultPawnClass, Location, FRotator::ZeroRotator, SpawnParameters))
+		{
+			BenchmarkCharacters.Add(Character);
+		}
+	}
+
+	bBudgetingBeforeBenchmark = TPSAnimBudget::Enabled != 0;
+	BenchmarkFramesPerPhase = FramesPerPhase;
+	SetBenchmarkPhase(EBenchmarkPhase::Warmup);
+
+	UE_LOG(LogTemp, Log, TEXT("%s() Spawned %d characters, sampling %d frames per phase"), *FString(__FUNCTION__), BenchmarkCharacters.Num(), FramesPerPhase);
+}
+
+void UTPSAnimationBudgetSubsystem::SetBenchmarkPhase(EBenchmarkPhase NewPhase)
+{
+	BenchmarkPhase = NewPhase;
+	BenchmarkFrame = 0;
+	BenchmarkAccumulatedMs = 0.0;
+
+	TPSAnimBudget::Enabled = NewPhase == EBenchmarkPhase::Budgeted ? 1 : 0;
+	ApplySettings();
+}
+
+void UTPSAnimationBudgetSubsystem::FinishBenchmark()
+{
+	const double BudgetedAverageMs = BenchmarkAccumulatedMs / BenchmarkFramesPerPhase;
+	const double SavedMs = UnbudgetedAverageMs - BudgetedAverageMs;
+
+	UE_LOG(LogTemp, Log, TEXT("TPSAnimBudget benchmark: characters=%d budget=%.2fms unbudgeted=%.3fms budgeted=%.3fms saved=%.3fms (%.1f%%)"),
+		BenchmarkCharacters.Num(), TPSAnimBudget::BudgetMs, UnbudgetedAverageMs, BudgetedAverageMs, SavedMs,
+		UnbudgetedAverageMs > 0.0 ? SavedMs / UnbudgetedAverageMs * 100.0 : 0.0);
+
+	for (ACharacter* Character : BenchmarkCharacters)
+	{
+		if (IsValid(Character))
+		{
+			Character->Destroy();
+		}
+	}
+	BenchmarkCharacters.Reset();
+
+	BenchmarkPhase = EBenchmarkPhase::None;
+	TPSAnimBudget::Enabled = bBudgetingBeforeBenchmark ? 1 : 0;
+	ApplySettings();
+}
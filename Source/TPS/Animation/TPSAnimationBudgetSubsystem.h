@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPSAnimationBudgetSubsystem.generated.h"
+
+class ACharacter;
+class USkeletalMeshComponentBudgeted;
+
+/**
+ * Opt-in animation budgeting for TPS characters.
+ * Drives the engine animation budget allocator from the tps.AnimBudget.* console variables and feeds it
+ * the significance computed by UTPSSignificanceManager, so remote characters are interpolated or skipped first.
+ * Readout: "stat TPSAnimBudget". Benchmark: "tps.AnimBudget.Benchmark [NumCharacters] [FramesPerPhase]".
+ */
+UCLASS()
+class TPS_API UTPSAnimationBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// True when the allocator owns the tick rate of budgeted meshes in this world
+	static bool IsBudgeting(const UWorld* World);
+
+	// Pushes the current console variable values to the allocator of this world
+	void ApplySettings();
+
+	// Spawns NumCharacters default pawns and compares game thread time with budgeting off and on
+	void StartBenchmark(int32 NumCharacters, int32 FramesPerPhase);
+
+private:
+	static float CalculateSignificance(USkeletalMeshComponentBudgeted* Component);
+
+	enum class EBenchmarkPhase : uint8
+	{
+		None,
+		Warmup,
+		Unbudgeted,
+		Budgeted
+	};
+
+	void SetBenchmarkPhase(EBenchmarkPhase NewPhase);
+
+	void FinishBenchmark();
+
+	int32 NumBudgetedComponents = 0;
+
+	EBenchmarkPhase BenchmarkPhase = EBenchmarkPhase::None;
+
+	int32 BenchmarkFramesPerPhase = 0;
+
+	int32 BenchmarkFrame = 0;
+
+	double BenchmarkAccumulatedMs = 0.0;
+
+	double UnbudgetedAverageMs = 0.0;
+
+	bool bBudgetingBeforeBenchmark = false;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ACharacter>> BenchmarkCharacters;
+};
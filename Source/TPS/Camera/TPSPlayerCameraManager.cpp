@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSPlayerCameraManager.h"
+#include "TPSCharacter.h"
+#include "TPSCharacterMovementComponent.h"
+#include "AbilitySystemComponent.h"
+#include "Camera/CameraComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Engine/World.h"
+
+ATPSPlayerCameraManager::ATPSPlayerCameraManager()
+{
+	AimDownSightMode.FieldOfView = 65.0f;
+	AimDownSightMode.ArmLength = 150.0f;
+	AimDownSightMode.SocketOffset = FVector(0.0f, 60.0f, 20.0f);
+
+	SprintMode.FieldOfView = 100.0f;
+	SprintMode.ArmLength = 450.0f;
+}
+
+void ATPSPlayerCameraManager::InitializeFor(APlayerController* PC)
+{
+	Super::InitializeFor(PC);
+
+	if (!AimDownSightTag.IsValid())
+	{
+		AimDownSightTag = FGameplayTag::RequestGameplayTag(FName("State.AimDownSight"));
+	}
+}
+
+void ATPSPlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
+{
+	const ATPSCharacter* Character = Cast<ATPSCharacter>(OutVT.Target);
+	if (!Character || !Character->GetCameraBoom() || !PCOwner)
+	{
+		bHasCurrentMode = false;
+		bHasCachedProbe = false;
+		Super::UpdateViewTarget(OutVT, DeltaTime);
+		return;
+	}
+
+	const FTPSCameraMode TargetMode = SelectMode(Character);
+	if (!bHasCurrentMode)
+	{
+		CurrentMode = TargetMode;
+		bHasCurrentMode = true;
+	}
+	else
+	{
+		CurrentMode.FieldOfView = FMath::FInterpTo(CurrentMode.FieldOfView, TargetMode.FieldOfView, DeltaTime, BlendSpeed);
+		CurrentMode.ArmLength = FMath::FInterpTo(CurrentMode.ArmLength, TargetMode.ArmLength, DeltaTime, BlendSpeed);
+		CurrentMode.SocketOffset = FMath::VInterpTo(CurrentMode.SocketOffset, TargetMode.SocketOffset, DeltaTime, BlendSpeed);
+	}
+
+	const USpringArmComponent* CameraBoom = Character->GetCameraBoom();
+	const FVector Pivot = CameraBoom->GetComponentLocation() + CameraBoom->TargetOffset;
+	const FRotator Rotation = PCOwner->GetControlRotation();
+	const FVector DesiredLocation = Pivot - Rotation.Vector() * CurrentMode.ArmLength + FRotationMatrix(Rotation).TransformVector(CurrentMode.SocketOffset);
+
+	OutVT.POV.Location = ProbeCollision(Character, Pivot, DesiredLocation);
+	OutVT.POV.Rotation = Rotation;
+	OutVT.POV.FOV = CurrentMode.FieldOfView;
+
+	ApplyCameraModifiers(DeltaTime, OutVT.POV);
+}
+
+FTPSCameraMode ATPSPlayerCameraManager::SelectMode(const ATPSCharacter* Character) const
+{
+	const UAbilitySystemComponent* AbilitySystemComponent = Character->GetAbilitySystemComponent();
+	if (AbilitySystemComponent && AbilitySystemComponent->HasMatchingGameplayTag(AimDownSightTag))
+	{
+		// GA_Scope zooms by writing the boom and camera, whatever it changed wins over the native defaults
+		const FTPSCameraMode HipMode = GetHipMode(Character);
+		const USpringArmComponent* CameraBoom = Character->GetCameraBoom();
+		const UCameraComponent* FollowCamera = Character->GetFollowCamera();
+
+		FTPSCameraMode Mode = AimDownSightMode;
+		if (!FMath::IsNearlyEqual(FollowCamera->FieldOfView, HipMode.FieldOfView))
+		{
+			Mode.FieldOfView = FollowCamera->FieldOfView;
+		}
+		if (!FMath::IsNearlyEqual(CameraBoom->TargetArmLength, HipMode.ArmLength))
+		{
+			Mode.ArmLength = CameraBoom->TargetArmLength;
+		}
+		if (!CameraBoom->SocketOffset.Equals(HipMode.SocketOffset))
+		{
+			Mode.SocketOffset = CameraBoom->SocketOffset;
+		}
+		return Mode;
+	}
+
+	const UTPSCharacterMovementComponent* MovementComponent = Cast<UTPSCharacterMovementComponent>(Character->GetCharacterMovement());
+	if (MovementComponent && MovementComponent->RequestToStartSprinting)
+	{
+		return SprintMode;
+	}
+
+	return GetHipMode(Character);
+}
+
+FTPSCameraMode ATPSPlayerCameraManager::GetHipMode(const ATPSCharacter* Character) const
+{
+	// Hip mode is what the character blueprint authored on its boom and camera, read from the templates
+	// so abilities changing the live components at runtime do not move it
+	const USpringArmComponent* BoomDefaults = CastChecked<USpringArmComponent>(Character->GetCameraBoom()->GetArchetype());
+	const UCameraComponent* CameraDefaults = CastChecked<UCameraComponent>(Character->GetFollowCamera()->GetArchetype());
+
+	FTPSCameraMode HipMode;
+	HipMode.FieldOfView = CameraDefaults->FieldOfView;
+	HipMode.ArmLength = BoomDefaults->TargetArmLength;
+	HipMode.SocketOffset = BoomDefaults->SocketOffset;
+	return HipMode;
+}
+
+FVector ATPSPlayerCameraManager::ProbeCollision(const ATPSCharacter* Character, const FVector& Pivot, const FVector& DesiredLocation)
+{
+	// A still camera sees the same world as last frame, unless what it hit has moved or the cache got old
+	if (bHasCachedProbe && GFrameCounter - CachedProbeFrame < static_cast<uint64>(FMath::Max(MaxCachedProbeFrames, 0))
+		&& Pivot.Equals(CachedProbeStart, 0.1f) && DesiredLocation.Equals(CachedProbeEnd, 0.1f))
+	{
+		const AActor* HitActor = CachedProbeHitActor.Get();
+		if (CachedProbeHitActor.IsExplicitlyNull() || (HitActor && HitActor->GetActorTransform().Equals(CachedProbeHitTransform, 0.1f)))
+		{
+			return CachedProbeResult;
+		}
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TPSCameraProbe), false, Character);
+	FHitResult Hit;
+	const bool bHit = GetWorld()->SweepSingleByChannel(Hit, Pivot, DesiredLocation, FQuat::Identity, ECC_Camera, FCollisionShape::MakeSphere(ProbeSize), QueryParams);
+
+	CachedProbeStart = Pivot;
+	CachedProbeEnd = DesiredLocation;
+	CachedProbeFrame = GFrameCounter;
+	CachedProbeHitActor = bHit ? Hit.GetActor() : nullptr;
+	CachedProbeHitTransform = bHit && Hit.GetActor() ? Hit.GetActor()->GetActorTransform() : FTransform::Identity;
+	bHasCachedProbe = true;
+
+	// Starting inside geometry means there is no clear point along the arm, so the camera pulls all the way in
+	if (bHit)
+	{
+		CachedProbeResult = Hit.bStartPenetrating ? Pivot : Hit.Location;
+	}
+	else
+	{
+		CachedProbeResult = DesiredLocation;
+	}
+
+	return CachedProbeResult;
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameplayTagContainer.h"
+#include "TPSPlayerCameraManager.generated.h"
+
+class ATPSCharacter;
+
+USTRUCT(BlueprintType)
+struct FTPSCameraMode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	float FieldOfView = 90.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	float ArmLength = 400.0f;
+
+	// Offset from the end of the arm, in camera space like USpringArmComponent::SocketOffset
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	FVector SocketOffset = FVector::ZeroVector;
+};
+
+/**
+ * Third person camera for TPS characters, replacing the per-tick spring arm and the blueprint FOV timelines.
+ * Hip mode comes from the character's CameraBoom and FollowCamera defaults, aim down sights is used while the
+ * AimDownSightTag is on the ASC (values the scope ability writes to the boom and camera take precedence) and sprint
+ * while the movement component is sprinting. The camera blends between
+ * modes and probes for collision with at most one sweep per frame, skipped for a few frames when the pivot, the arm
+ * and whatever the last probe hit did not move.
+ */
+UCLASS()
+class TPS_API ATPSPlayerCameraManager : public APlayerCameraManager
+{
+	GENERATED_BODY()
+
+public:
+	ATPSPlayerCameraManager();
+
+	// Used while aiming for every value the scope ability leaves untouched on the character's boom and camera
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	FTPSCameraMode AimDownSightMode;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	FTPSCameraMode SprintMode;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	FGameplayTag AimDownSightTag;
+
+	// Interpolation speed when switching modes
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	float BlendSpeed = 12.0f;
+
+	// Radius of the collision probe between the pivot and the camera
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	float ProbeSize = 12.0f;
+
+	// Frames a still camera reuses its probe before sweeping again, so actors moving into the arm are still caught
+	UPROPERTY(EditDefaultsOnly, Category = "Camera")
+	int32 MaxCachedProbeFrames = 10;
+
+	virtual void InitializeFor(APlayerController* PC) override;
+
+protected:
+	virtual void UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime) override;
+
+private:
+	FTPSCameraMode SelectMode(const ATPSCharacter* Character) const;
+
+	FTPSCameraMode GetHipMode(const ATPSCharacter* Character) const;
+
+	FVector ProbeCollision(const ATPSCharacter* Character, const FVector& Pivot, const FVector& DesiredLocation);
+
+	FTPSCameraMode CurrentMode;
+
+	bool bHasCurrentMode = false;
+
+	FVector CachedProbeStart = FVector::ZeroVector;
+
+	FVector CachedProbeEnd = FVector::ZeroVector;
+
+	FVector CachedProbeResult = FVector::ZeroVector;
+
+	// The actor the cached probe hit and where it was, the probe is redone as soon as it moves
+	TWeakObjectPtr<const AActor> CachedProbeHitActor;
+
+	FTransform CachedProbeHitTransform;
+
+	uint64 CachedProbeFrame = 0;
+
+	bool bHasCachedProbe = false;
+};
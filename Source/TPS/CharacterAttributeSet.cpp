@@ -3,6 +3,10 @@
 
 #include "CharacterAttributeSet.h"
 #include "Net/UnrealNetwork.h"
+#include "GameplayEffectExtension.h"
+#include "AbilitySystemComponent.h"
+#include "Combat/TPSHitPredictionComponent.h"
+#include "TPSStats.h"
 
 void UCharacterAttributeSet::OnRep_Health(const FGameplayAttributeData& OldHealth)
 {
@@ -15,3 +19,17 @@ void UCharacterAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 
 	DOREPLIFETIME_CONDITION_NOTIFY(UCharacterAttributeSet, Health, COND_None, REPNOTIFY_Always);
 }
+
+void UCharacterAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
+{
+	Super::PostGameplayEffectExecute(Data);
+
+	if (Data.EvaluatedData.Attribute == GetHealthAttribute() && Data.EvaluatedData.Magnitude < 0.0f)
+	{
+		INC_DWORD_STAT(STAT_TPS_DamageApplications);
+		CSV_CUSTOM_STAT(TPS, DamageApplications, 1, ECsvCustomStatOp::Accumulate);
+
+		// The health drop replicates to everyone, only the instigator learns that it was their hit
+		UTPSHitPredictionComponent::NotifyDamageApplied(Data.EffectSpec.GetContext(), Data.Target.GetAvatarActor(), -Data.EvaluatedData.Magnitude, GetHealth());
+	}
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSHitPredictionComponent.h"
+#include "TPSCharacter.h"
+#include "TPSPlayerController.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayEffectTypes.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+#include "TPSStats.h"
+
+UTPSHitPredictionComponent::UTPSHitPredictionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Confirmations arrive as client RPCs on the owning player controller
+	SetIsReplicatedByDefault(true);
+}
+
+void UTPSHitPredictionComponent::NotifyDamageApplied(const FGameplayEffectContextHandle& EffectContext, AActor* Target, float Damage, float Health)
+{
+	const UAbilitySystemComponent* InstigatorAbilitySystem = EffectContext.GetInstigatorAbilitySystemComponent();
+	const FGameplayAbilityActorInfo* ActorInfo = InstigatorAbilitySystem ? InstigatorAbilitySystem->AbilityActorInfo.Get() : nullptr;
+	const ATPSPlayerController* PlayerController = ActorInfo ? Cast<ATPSPlayerController>(ActorInfo->PlayerController.Get()) : nullptr;
+
+	// Bots have nothing to confirm and a listen server host already showed authoritative health
+	if (!Target || !PlayerController || PlayerController->IsLocalController() || !PlayerController->GetHitPrediction())
+	{
+		return;
+	}
+
+	PlayerController->GetHitPrediction()->ClientConfirmHit(Target, Damage, Health);
+}
+
+void UTPSHitPredictionComponent::PredictHit(AActor* Target, float Damage)
+{
+	ATPSCharacter* Character = Cast<ATPSCharacter>(Target);
+	if (!Character || !Character->IsAlive() || Damage <= 0.0f)
+	{
+		return;
+	}
+
+	// The server applies damage itself, its Health is already authoritative
+	if (GetNetMode() != NM_Client)
+	{
+		OnHitPredicted.Broadcast(Target, Damage, Character->GetHealth());
+		return;
+	}
+
+	const float PredictedHealthBefore = GetPredictedHealth(Target);
+	if (PredictedHealthBefore <= 0.0f)
+	{
+		return;
+	}
+
+	FPredictedHit& Hit = PendingTargets.FindOrAdd(Target).AddDefaulted_GetRef();
+	Hit.Damage = FMath::Min(Damage, PredictedHealthBefore);
+	Hit.ExpireTime = GetWorld()->GetTimeSeconds() + GetConfirmWindow();
+
+	SetComponentTickEnabled(true);
+
+	INC_DWORD_STAT(STAT_TPS_PredictedHits);
+	CSV_CUSTOM_STAT(TPS, PredictedHits, 1, ECsvCustomStatOp::Accumulate);
+
+	OnHitPredicted.Broadcast(Target, Hit.Damage, PredictedHealthBefore - Hit.Damage);
+}
+
+float UTPSHitPredictionComponent::GetPredictedHealth(AActor* Target) const
+{
+	const ATPSCharacter* Character = Cast<ATPSCharacter>(Target);
+	if (!Character)
+	{
+		return 0.0f;
+	}
+
+	float Health = Character->GetHealth();
+	if (const TArray<FPredictedHit>* Hits = PendingTargets.Find(Target))
+	{
+		for (const FPredictedHit& Hit : *Hits)
+		{
+			Health -= Hit.Damage;
+		}
+	}
+	return FMath::Max(Health, 0.0f);
+}
+
+float UTPSHitPredictionComponent::GetDisagreementRate() const
+{
+	const int32 NumResolved = NumConfirmed + NumRolledBack;
+	return NumResolved > 0 ? static_cast<float>(NumRolledBack + NumDamageMismatches) / NumResolved : 0.0f;
+}
+
+void UTPSHitPredictionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<4>> EmptyTargets;
+	TArray<TPair<TWeakObjectPtr<AActor>, float>, TInlineAllocator<4>> RolledBack;
+	for (TPair<TWeakObjectPtr<AActor>, TArray<FPredictedHit>>& Pair : PendingTargets)
+	{
+		// Hits are resolved in order, only the oldest ones can have run out of time
+		TArray<FPredictedHit>& Hits = Pair.Value;
+		while (Hits.Num() > 0 && (!Pair.Key.IsValid() || Hits[0].ExpireTime <= Now))
+		{
+			RolledBack.Emplace(Pair.Key, Hits[0].Damage);
+			Hits.RemoveAt(0);
+		}
+
+		if (Hits.Num() == 0)
+		{
+			EmptyTargets.Add(Pair.Key);
+		}
+	}
+
+	for (const TWeakObjectPtr<AActor>& Target : EmptyTargets)
+	{
+		PendingTargets.Remove(Target);
+	}
+
+	if (PendingTargets.Num() == 0)
+	{
+		SetComponentTickEnabled(false);
+	}
+
+	// Broadcast last, listeners may predict new hits
+	for (const TPair<TWeakObjectPtr<AActor>, float>& Hit : RolledBack)
+	{
+		++NumRolledBack;
+		INC_DWORD_STAT(STAT_TPS_RolledBackHits);
+		CSV_CUSTOM_STAT(TPS, RolledBackHits, 1, ECsvCustomStatOp::Accumulate);
+
+		if (const ATPSCharacter* Character = Cast<ATPSCharacter>(Hit.Key.Get()))
+		{
+			OnHitRolledBack.Broadcast(Hit.Key.Get(), Hit.Value, Character->GetHealth());
+		}
+	}
+}
+
+void UTPSHitPredictionComponent::ClientConfirmHit_Implementation(AActor* Target, float Damage, float Health)
+{
+	TArray<FPredictedHit>* Hits = PendingTargets.Find(Target);
+	if (!Hits || Hits->Num() == 0 || Damage <= 0.0f)
+	{
+		return;
+	}
+
+	// One server application can cover several predicted hits, e.g. pellets or shots merged into one effect,
+	// so the oldest hits are consumed until they account for the applied damage
+	float PredictedDamage = 0.0f;
+	int32 NumHits = 0;
+	while (NumHits < Hits->Num() && PredictedDamage < Damage - DamageTolerance)
+	{
+		PredictedDamage += (*Hits)[NumHits].Damage;
+		++NumHits;
+	}
+	Hits->RemoveAt(0, NumHits);
+
+	if (Hits->Num() == 0)
+	{
+		PendingTargets.Remove(Target);
+	}
+
+	NumConfirmed += NumHits;
+	INC_DWORD_STAT_BY(STAT_TPS_ConfirmedHits, NumHits);
+	CSV_CUSTOM_STAT(TPS, ConfirmedHits, NumHits, ECsvCustomStatOp::Accumulate);
+
+	if (!FMath::IsNearlyEqual(PredictedDamage, Damage, DamageTolerance))
+	{
+		++NumDamageMismatches;
+	}
+
+	OnHitConfirmed.Broadcast(Target, Damage, Health);
+}
+
+float UTPSHitPredictionComponent::GetConfirmWindow() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	const APlayerState* PlayerState = PlayerController ? PlayerController->PlayerState.Get() : nullptr;
+	const float RoundTripSeconds = PlayerState ? PlayerState->GetPingInMilliseconds() / 1000.0f : 0.2f;
+
+	// Twice the round trip leaves room for the server frame and the target's player state update interval
+	return RoundTripSeconds * 2.0f + ConfirmGraceSeconds;
+}
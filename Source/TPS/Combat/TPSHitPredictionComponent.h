@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TPSHitPredictionComponent.generated.h"
+
+struct FGameplayEffectContextHandle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FTPSHitPredictionDelegate, AActor*, Target, float, Damage, float, Health);
+
+/**
+ * Client-side predicted damage for hit markers and health bars.
+ * The fire ability calls PredictHit right after its local trace, which shows the hit and a provisional health straight away.
+ * The server tells the instigating player about every damage it applies, which confirms the oldest pending hits on that
+ * target. Damage from other players never confirms a prediction. A hit not confirmed within the confirm window (ping based)
+ * is rolled back. Nothing is sent to the server, this only decides what the HUD shows.
+ * Inert until content calls it: the fire trace lives in GA_BaseFireAbility, which has to call UTPSGameplayAbility::PredictHit
+ * with the trace's hit actor and the Data.Damage magnitude after WaitTargetData, and the HUD has to bind the delegates below.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class TPS_API UTPSHitPredictionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTPSHitPredictionComponent();
+
+	// Shown right away: hit marker and provisional health
+	UPROPERTY(BlueprintAssignable, Category = "Hit Prediction")
+	FTPSHitPredictionDelegate OnHitPredicted;
+
+	// The server applied this player's hit, Damage is what it actually applied and Health is the server's value after it
+	UPROPERTY(BlueprintAssignable, Category = "Hit Prediction")
+	FTPSHitPredictionDelegate OnHitConfirmed;
+
+	// The server never applied the hit, Damage is what was predicted and Health is the replicated value to restore
+	UPROPERTY(BlueprintAssignable, Category = "Hit Prediction")
+	FTPSHitPredictionDelegate OnHitRolledBack;
+
+	// Seconds added to the round trip time before an unconfirmed hit is rolled back
+	UPROPERTY(EditDefaultsOnly, Category = "Hit Prediction")
+	float ConfirmGraceSeconds = 0.25f;
+
+	// Confirmed damage further than this from the prediction counts as a disagreement
+	UPROPERTY(EditDefaultsOnly, Category = "Hit Prediction")
+	float DamageTolerance = 1.0f;
+
+	// Call from the locally controlled fire ability after its own trace hit Target
+	UFUNCTION(BlueprintCallable, Category = "Hit Prediction")
+	void PredictHit(AActor* Target, float Damage);
+
+	// Called on the server for every Health drop an effect applies, confirms it to the player whose ability instigated it
+	static void NotifyDamageApplied(const FGameplayEffectContextHandle& EffectContext, AActor* Target, float Damage, float Health);
+
+	// Replicated health of Target minus the damage of its pending hits
+	UFUNCTION(BlueprintPure, Category = "Hit Prediction")
+	float GetPredictedHealth(AActor* Target) const;
+
+	// Fraction of resolved hits that were rolled back or confirmed with a different damage
+	UFUNCTION(BlueprintPure, Category = "Hit Prediction")
+	float GetDisagreementRate() const;
+
+	int32 GetNumConfirmed() const { return NumConfirmed; }
+
+	int32 GetNumRolledBack() const { return NumRolledBack; }
+
+	int32 GetNumDamageMismatches() const { return NumDamageMismatches; }
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	struct FPredictedHit
+	{
+		float Damage = 0.0f;
+
+		double ExpireTime = 0.0;
+	};
+
+	UFUNCTION(Client, Reliable)
+	void ClientConfirmHit(AActor* Target, float Damage, float Health);
+
+	float GetConfirmWindow() const;
+
+	// Unresolved hits per target, oldest first
+	TMap<TWeakObjectPtr<AActor>, TArray<FPredictedHit>> PendingTargets;
+
+	int32 NumConfirmed = 0;
+
+	int32 NumRolledBack = 0;
+
+	int32 NumDamageMismatches = 0;
+};
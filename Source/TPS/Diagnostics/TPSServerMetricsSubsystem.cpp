@@ -0,0 +1,244 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSServerMetricsSubsystem.h"
+#include "Abilities/GameplayAbility.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectArray.h"
+#include "TPSStats.h"
+#include "Net/TPSAdaptiveNetUpdate.h"
+
+namespace TPSMetrics
+{
+	static constexpr int32 MaxFrameSamples = 4096;
+
+	static int32 Enabled = 1;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("tps.Metrics.Enabled"),
+		Enabled,
+		TEXT("Collect server metrics and write them as JSON lines (0: off, 1: on)."));
+
+	static float IntervalSeconds = 10.0f;
+	static FAutoConsoleVariableRef CVarIntervalSeconds(
+		TEXT("tps.Metrics.IntervalSeconds"),
+		IntervalSeconds,
+		TEXT("Seconds between metrics lines."));
+
+	static FString FileName;
+	static FAutoConsoleVariableRef CVarFileName(
+		TEXT("tps.Metrics.File"),
+		FileName,
+		TEXT("File under Saved/Metrics that metrics lines are appended to. Empty writes them to the log."));
+
+	static FAutoConsoleCommandWithWorld CmdDump(
+		TEXT("tps.Metrics.Dump"),
+		TEXT("Writes the server metrics gathered so far and starts a new interval."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UTPSServerMetricsSubsystem* Subsystem = World ? World->GetSubsystem<UTPSServerMetricsSubsystem>() : nullptr)
+			{
+				Subsystem->WriteMetrics();
+			}
+		}));
+
+	// Nearest-rank percentile of an already sorted array
+	static float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		if (Sorted.Num() == 0)
+		{
+			return 0.0f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+}
+
+bool UTPSServerMetricsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() == NM_DedicatedServer && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UTPSServerMetricsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTPSServerMetricsSubsystem, STATGROUP_Tickables);
+}
+
+void UTPSServerMetricsSubsystem::NotifyAbilityActivated(const UWorld* World, const UGameplayAbility* Ability)
+{
+	UTPSServerMetricsSubsystem* Subsystem = World && Ability ? World->GetSubsystem<UTPSServerMetricsSubsystem>() : nullptr;
+	if (Subsystem && TPSMetrics::Enabled)
+	{
+		++Subsystem->AbilityActivations.FindOrAdd(Ability->GetClass()->GetFName());
+	}
+}
+
+void UTPSServerMetricsSubsystem::NotifyMovementCorrection(const UWorld* World)
+{
+	UTPSServerMetricsSubsystem* Subsystem = World ? World->GetSubsystem<UTPSServerMetricsSubsystem>() : nullptr;
+	if (Subsystem && TPSMetrics::Enabled)
+	{
+		++Subsystem->NumMovementCorrections;
+	}
+}
+
+void UTPSServerMetricsSubsystem::Tick(float DeltaTime)
+{
+	if (!TPSMetrics::Enabled)
+	{
+		return;
+	}
+
+	TPS_SCOPE_CYCLE_COUNTER(ServerMetrics);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const double Now = FPlatformTime::Seconds();
+	if (IntervalStartTime == 0.0)
+	{
+		IntervalStartTime = Now;
+	}
+
+	// Game thread time rather than delta time, a server limited by its tick rate sleeps for most of the frame
+	const float FrameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	if (FrameTimesMs.Num() < TPSMetrics::MaxFrameSamples)
+	{
+		FrameTimesMs.Add(FrameMs);
+	}
+	else
+	{
+		FrameTimesMs[NextFrameSample] = FrameMs;
+		NextFrameSample = (NextFrameSample + 1) % TPSMetrics::MaxFrameSamples;
+	}
+	++NumFrames;
+
+	SampleConnections();
+
+	SampleCostMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	if (Now - IntervalStartTime >= FMath::Max(TPSMetrics::IntervalSeconds, 1.0f))
+	{
+		WriteMetrics();
+	}
+}
+
+void UTPSServerMetricsSubsystem::SampleConnections()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver)
+	{
+		return;
+	}
+
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection && !Connection->IsNetReady(false))
+		{
+			++SaturatedFrames.FindOrAdd(Connection);
+		}
+	}
+}
+
+void UTPSServerMetricsSubsystem::WriteMetrics()
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const UWorld* World = GetWorld();
+	const double Now = FPlatformTime::Seconds();
+	const double IntervalSeconds = IntervalStartTime > 0.0 ? FMath::Max(Now - IntervalStartTime, UE_DOUBLE_SMALL_NUMBER) : UE_DOUBLE_SMALL_NUMBER;
+
+	TArray<float> SortedFrameTimesMs = FrameTimesMs;
+	SortedFrameTimesMs.Sort();
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+	Json->SetStringField(TEXT("map"), World->GetMapName());
+	Json->SetNumberField(TEXT("intervalSeconds"), IntervalSeconds);
+	Json->SetNumberField(TEXT("frames"), NumFrames);
+	Json->SetNumberField(TEXT("frameMsP50"), TPSMetrics::Percentile(SortedFrameTimesMs, 0.5f));
+	Json->SetNumberField(TEXT("frameMsP90"), TPSMetrics::Percentile(SortedFrameTimesMs, 0.9f));
+	Json->SetNumberField(TEXT("frameMsP99"), TPSMetrics::Percentile(SortedFrameTimesMs, 0.99f));
+	Json->SetNumberField(TEXT("frameMsMax"), SortedFrameTimesMs.Num() > 0 ? SortedFrameTimesMs.Last() : 0.0f);
+	Json->SetNumberField(TEXT("sampleMsPerFrame"), NumFrames > 0 ? SampleCostMs / NumFrames : 0.0);
+	Json->SetNumberField(TEXT("correctionsPerSecond"), NumMovementCorrections / IntervalSeconds);
+	const UTPSAdaptiveNetUpdateSubsystem* AdaptiveNetUpdate = World->GetSubsystem<UTPSAdaptiveNetUpdateSubsystem>();
+	Json->SetNumberField(TEXT("netHzSaved"), AdaptiveNetUpdate ? AdaptiveNetUpdate->GetTotalHzSaved() : 0.0f);
+	Json->SetNumberField(TEXT("actors"), World->GetActorCount());
+	Json->SetNumberField(TEXT("objects"), GUObjectArray.GetObjectArrayNumMinusAvailable());
+
+	int32 NumActivations = 0;
+	TSharedRef<FJsonObject> AbilitiesJson = MakeShared<FJsonObject>();
+	for (const TPair<FName, int32>& Pair : AbilityActivations)
+	{
+		AbilitiesJson->SetNumberField(Pair.Key.ToString(), Pair.Value / IntervalSeconds);
+		NumActivations += Pair.Value;
+	}
+	Json->SetNumberField(TEXT("activationsPerSecond"), NumActivations / IntervalSeconds);
+	Json->SetObjectField(TEXT("abilityActivationsPerSecond"), AbilitiesJson);
+
+	TArray<TSharedPtr<FJsonValue>> ConnectionsJson;
+	if (const UNetDriver* NetDriver = World->GetNetDriver())
+	{
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (!Connection)
+			{
+				continue;
+			}
+
+			const APlayerState* PlayerState = Connection->PlayerController ? Connection->PlayerController->PlayerState.Get() : nullptr;
+			const int32* Saturated = SaturatedFrames.Find(Connection);
+
+			TSharedRef<FJsonObject> ConnectionJson = MakeShared<FJsonObject>();
+			ConnectionJson->SetStringField(TEXT("player"), PlayerState ? PlayerState->GetPlayerName() : Connection->LowLevelGetRemoteAddress());
+			ConnectionJson->SetNumberField(TEXT("pingMs"), PlayerState ? PlayerState->GetPingInMilliseconds() : 0.0f);
+			ConnectionJson->SetNumberField(TEXT("saturatedFraction"), Saturated && NumFrames > 0 ? static_cast<double>(*Saturated) / NumFrames : 0.0);
+			ConnectionJson->SetNumberField(TEXT("queuedBits"), Connection->QueuedBits);
+			ConnectionJson->SetNumberField(TEXT("outBytesPerSecond"), Connection->OutBytesPerSecond);
+			ConnectionJson->SetNumberField(TEXT("inBytesPerSecond"), Connection->InBytesPerSecond);
+			ConnectionJson->SetNumberField(TEXT("outLoss"), Connection->GetOutLossPercentage().GetAvgLossPercentage());
+			ConnectionsJson.Add(MakeShared<FJsonValueObject>(ConnectionJson));
+		}
+	}
+	Json->SetArrayField(TEXT("connections"), ConnectionsJson);
+
+	FString Line;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+	FJsonSerializer::Serialize(Json, Writer);
+	WriteLine(Line);
+
+	FrameTimesMs.Reset();
+	NextFrameSample = 0;
+	NumFrames = 0;
+	IntervalStartTime = Now;
+	NumMovementCorrections = 0;
+	AbilityActivations.Reset();
+	SaturatedFrames.Reset();
+
+	// Building and writing the line is most of the collector's cost, it is charged to the next interval since this one is already written
+	SampleCostMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+}
+
+void UTPSServerMetricsSubsystem::WriteLine(const FString& Line)
+{
+	if (!TPSMetrics::FileName.IsEmpty())
+	{
+		// One append per interval, cheap enough that the file does not need to stay open
+		const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Metrics"), TPSMetrics::FileName);
+		if (FFileHelper::SaveStringToFile(Line + LINE_TERMINATOR, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+		{
+			return;
+		}
+		UE_LOG(LogTemp, Error, TEXT("%s() Could not write %s, writing to the log instead"), *FString(__FUNCTION__), *Path);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("TPSMetrics %s"), *Line);
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPSServerMetricsSubsystem.generated.h"
+
+class UGameplayAbility;
+class UNetConnection;
+
+/**
+ * In-process health metrics for dedicated servers, for the log pipeline rather than Insights.
+ * Every frame only the game thread time is sampled; every tps.Metrics.IntervalSeconds the collector writes one JSON line
+ * with frame time percentiles, per-connection saturation, ability activations, movement corrections and actor/object counts
+ * to Saved/Metrics/<tps.Metrics.File>, or to the log when the file name is empty. "tps.Metrics.Dump" writes a line immediately.
+ */
+UCLASS()
+class TPS_API UTPSServerMetricsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Called by UTPSGameplayAbility on every activation the server runs
+	static void NotifyAbilityActivated(const UWorld* World, const UGameplayAbility* Ability);
+
+	// Called by UTPSCharacterMovementComponent when the server sends a client a position correction
+	static void NotifyMovementCorrection(const UWorld* World);
+
+	// Writes the metrics gathered since the last line and starts a new interval
+	void WriteMetrics();
+
+private:
+	void SampleConnections();
+
+	void WriteLine(const FString& Line);
+
+	// Game thread milliseconds per frame, a ring of the most recent MaxFrameSamples frames of the interval
+	TArray<float> FrameTimesMs;
+
+	int32 NextFrameSample = 0;
+
+	int32 NumFrames = 0;
+
+	double IntervalStartTime = 0.0;
+
+	double SampleCostMs = 0.0;
+
+	int32 NumMovementCorrections = 0;
+
+	TMap<FName, int32> AbilityActivations;
+
+	// Frames each connection could not send anything else, keyed by connection
+	TMap<TWeakObjectPtr<UNetConnection>, int32> SaturatedFrames;
+};
@@ -3,6 +3,14 @@
 
 #include "TPSGameplayAbility.h"
 #include "AbilitySystemComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "TPSAssetManager.h"
+#include "TPSStats.h"
+#include "Diagnostics/TPSServerMetricsSubsystem.h"
+#include "Net/TPSCheatValidation.h"
+#include "Combat/TPSHitPredictionComponent.h"
+#include "TPSPlayerController.h"
+#include "GameFramework/PlayerState.h"
 
 UTPSGameplayAbility::UTPSGameplayAbility()
 {
@@ -17,3 +25,48 @@ void UTPSGameplayAbility::OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo
 		ActorInfo->AbilitySystemComponent->TryActivateAbility(Spec.Handle, false);
 	}
 }
+
+void UTPSGameplayAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
+{
+	TPS_SCOPE_CYCLE_COUNTER(AbilityActivation);
+
+	if (ActorInfo && ActorInfo->OwnerActor.IsValid())
+	{
+		UTPSServerMetricsSubsystem::NotifyAbilityActivated(ActorInfo->OwnerActor->GetWorld(), this);
+	}
+
+	if (MinActivationInterval > 0.0f && ActorInfo && ActorInfo->IsNetAuthority() && ActorInfo->OwnerActor.IsValid())
+	{
+		UTPSCheatValidationSubsystem::ReportShot(ActorInfo->OwnerActor->GetWorld(), Cast<APlayerState>(ActorInfo->OwnerActor.Get()), GetClass()->GetFName(), MinActivationInterval);
+	}
+
+	Super::ActivateAbility(Handle, ActorInfo, ActivationInfo, TriggerEventData);
+}
+
+void UTPSGameplayAbility::PredictHit(AActor* Target, float Damage) const
+{
+	const FGameplayAbilityActorInfo* ActorInfo = GetCurrentActorInfo();
+	if (!ActorInfo || !ActorInfo->IsLocallyControlledPlayer())
+	{
+		return;
+	}
+
+	const ATPSPlayerController* PlayerController = Cast<ATPSPlayerController>(ActorInfo->PlayerController.Get());
+	if (UTPSHitPredictionComponent* HitPrediction = PlayerController ? PlayerController->GetHitPrediction() : nullptr)
+	{
+		HitPrediction->PredictHit(Target, Damage);
+	}
+}
+
+FPrimaryAssetId UTPSGameplayAbility::GetPrimaryAssetId() const
+{
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		if (const UBlueprintGeneratedClass* BlueprintClass = Cast<UBlueprintGeneratedClass>(GetClass()))
+		{
+			return FPrimaryAssetId(UTPSAssetManager::AbilityType, FPackageName::GetShortFName(BlueprintClass->GetOutermost()->GetName()));
+		}
+	}
+
+	return Super::GetPrimaryAssetId();
+}
@@ -31,7 +31,23 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ability")
 	bool ActivateAbilityOnGranted = false;
 
+	// Shortest time between activations the weapon allows, e.g. 60 / rounds per minute. The server flags remote players
+	// that activate faster. 0 disables the check
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Ability")
+	float MinActivationInterval = 0.0f;
+
 	// If an ability is marked as 'ActivateAbilityOnGranted', activate them immediately when given here
 	// Epic's comment: Projects may want to initiate passives or do other "BeginPlay" type of logic here.
 	virtual void OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
+
+	// Times the synchronous part of activation, which for fire abilities includes the trace and applying damage
+	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
+
+	// Shows a predicted hit marker on the local player's UTPSHitPredictionComponent, call from fire abilities right after
+	// their local trace hit Target. Does nothing on the server or for bots
+	UFUNCTION(BlueprintCallable, Category = "Ability")
+	void PredictHit(AActor* Target, float Damage) const;
+
+	// Blueprint abilities are TPSAbility primary assets so the asset manager can preload them
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
 };
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSCuePoolSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Engine/World.h"
+
+bool UTPSCuePoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Dedicated servers never spawn cosmetics
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTPSCuePoolSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : AudioPool)
+	{
+		if (IsValid(AudioComponent))
+		{
+			AudioComponent->DestroyComponent();
+		}
+	}
+	AudioPool.Reset();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UTPSCuePoolSubsystem::SpawnEmitterAtLocation(UParticleSystem* Template, FVector Location, FRotator Rotation, FVector Scale)
+{
+	if (!Template)
+	{
+		return nullptr;
+	}
+
+	// The world particle component pool hands the component back once the effect finishes
+	return UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Template, FTransform(Rotation, Location, Scale), true, EPSCPoolMethod::AutoRelease);
+}
+
+UParticleSystemComponent* UTPSCuePoolSubsystem::SpawnEmitterAttached(UParticleSystem* Template, USceneComponent* AttachToComponent, FName AttachPointName)
+{
+	if (!Template || !AttachToComponent)
+	{
+		return nullptr;
+	}
+
+	return UGameplayStatics::SpawnEmitterAttached(Template, AttachToComponent, AttachPointName, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f),
+		EAttachLocation::KeepRelativeOffset, true, EPSCPoolMethod::AutoRelease);
+}
+
+void UTPSCuePoolSubsystem::PlaySoundAtLocation(USoundBase* Sound, FVector Location, float VolumeMultiplier, float PitchMultiplier, USoundAttenuation* AttenuationSettings)
+{
+	if (!Sound)
+	{
+		return;
+	}
+
+	if (UAudioComponent* AudioComponent = FindIdleAudioComponent())
+	{
+		AudioComponent->SetWorldLocation(Location);
+		AudioComponent->SetSound(Sound);
+		AudioComponent->SetVolumeMultiplier(VolumeMultiplier);
+		AudioComponent->SetPitchMultiplier(PitchMultiplier);
+		AudioComponent->AttenuationSettings = AttenuationSettings;
+		AudioComponent->Play();
+		return;
+	}
+
+	if (AudioPool.Num() >= MaxPooledAudioComponents)
+	{
+		UGameplayStatics::PlaySoundAtLocation(GetWorld(), Sound, Location, FRotator::ZeroRotator, VolumeMultiplier, PitchMultiplier, 0.0f, AttenuationSettings);
+		return;
+	}
+
+	// Not auto destroyed, so the component stays around for the next cue once it finishes
+	UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAtLocation(GetWorld(), Sound, Location, FRotator::ZeroRotator,
+		VolumeMultiplier, PitchMultiplier, 0.0f, AttenuationSettings, nullptr, false);
+	if (AudioComponent)
+	{
+		AudioPool.Add(AudioComponent);
+	}
+}
+
+UAudioComponent* UTPSCuePoolSubsystem::FindIdleAudioComponent()
+{
+	AudioPool.RemoveAllSwap([](const UAudioComponent* AudioComponent) { return !IsValid(AudioComponent); });
+
+	for (UAudioComponent* AudioComponent : AudioPool)
+	{
+		if (!AudioComponent->IsPlaying())
+		{
+			return AudioComponent;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPSCuePoolSubsystem.generated.h"
+
+class UAudioComponent;
+class UParticleSystem;
+class UParticleSystemComponent;
+class USceneComponent;
+class USoundBase;
+class USoundAttenuation;
+
+/**
+ * Pooled spawning for gameplay cue cosmetics (muzzle flashes, impacts, shot sounds).
+ * Cues should call these instead of SpawnEmitter / SpawnSound so components are reused instead of created per shot.
+ */
+UCLASS()
+class TPS_API UTPSCuePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Most audio components kept alive for reuse. Sounds played while all of them are busy are fire and forget
+	UPROPERTY(EditAnywhere, Category = "Pool")
+	int32 MaxPooledAudioComponents = 32;
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Cue Pool")
+	UParticleSystemComponent* SpawnEmitterAtLocation(UParticleSystem* Template, FVector Location, FRotator Rotation, FVector Scale = FVector(1.0f));
+
+	UFUNCTION(BlueprintCallable, Category = "Cue Pool")
+	UParticleSystemComponent* SpawnEmitterAttached(UParticleSystem* Template, USceneComponent* AttachToComponent, FName AttachPointName = NAME_None);
+
+	UFUNCTION(BlueprintCallable, Category = "Cue Pool")
+	void PlaySoundAtLocation(USoundBase* Sound, FVector Location, float VolumeMultiplier = 1.0f, float PitchMultiplier = 1.0f, USoundAttenuation* AttenuationSettings = nullptr);
+
+private:
+	UAudioComponent* FindIdleAudioComponent();
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> AudioPool;
+};
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSGameplayCueManager.h"
+#include "AbilitySystemComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "TPSStats.h"
+
+namespace TPSGameplayCues
+{
+	// Every ExecuteGameplayCue call builds its own context, so contexts are compared by what the cue reads from them
+	static bool HaveSameEffectContext(const FGameplayEffectContextHandle& A, const FGameplayEffectContextHandle& B)
+	{
+		if (!A.IsValid() || !B.IsValid())
+		{
+			return A.IsValid() == B.IsValid();
+		}
+
+		if (A.GetInstigator() != B.GetInstigator()
+			|| A.GetEffectCauser() != B.GetEffectCauser()
+			|| A.HasOrigin() != B.HasOrigin()
+			|| (A.HasOrigin() && !A.GetOrigin().Equals(B.GetOrigin())))
+		{
+			return false;
+		}
+
+		const FHitResult* HitA = A.GetHitResult();
+		const FHitResult* HitB = B.GetHitResult();
+		if (!HitA || !HitB)
+		{
+			return HitA == HitB;
+		}
+
+		return HitA->GetActor() == HitB->GetActor()
+			&& HitA->GetComponent() == HitB->GetComponent()
+			&& HitA->ImpactPoint.Equals(HitB->ImpactPoint)
+			&& HitA->ImpactNormal.Equals(HitB->ImpactNormal);
+	}
+
+	static bool HaveSameParameters(const FGameplayCuePendingExecute& A, const FGameplayCuePendingExecute& B)
+	{
+		const FGameplayCueParameters& ParamsA = A.CueParameters;
+		const FGameplayCueParameters& ParamsB = B.CueParameters;
+
+		return A.OwningComponent == B.OwningComponent
+			&& A.PredictionKey == B.PredictionKey
+			&& ParamsA.Location.Equals(ParamsB.Location)
+			&& ParamsA.Normal.Equals(ParamsB.Normal)
+			&& ParamsA.Instigator == ParamsB.Instigator
+			&& ParamsA.EffectCauser == ParamsB.EffectCauser
+			&& ParamsA.SourceObject == ParamsB.SourceObject
+			&& HaveSameEffectContext(ParamsA.EffectContext, ParamsB.EffectContext)
+			&& ParamsA.RawMagnitude == ParamsB.RawMagnitude
+			&& ParamsA.NormalizedMagnitude == ParamsB.NormalizedMagnitude;
+	}
+}
+
+UTPSGameplayCueManager::UTPSGameplayCueManager(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+void UTPSGameplayCueManager::OnCreated()
+{
+	Super::OnCreated();
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UTPSGameplayCueManager::OnWorldTickStart);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UTPSGameplayCueManager::OnWorldPostActorTick);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UTPSGameplayCueManager::OnWorldCleanup);
+}
+
+void UTPSGameplayCueManager::BeginDestroy()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+	Super::BeginDestroy();
+}
+
+void UTPSGameplayCueManager::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Only the server multicasts cues, clients keep executing their predicted cues immediately
+	if (!World || !World->IsGameWorld() || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	// A world that never reached post actor tick last frame still holds its context
+	if (WorldsWithFrameContext.Contains(World))
+	{
+		return;
+	}
+
+	StartGameplayCueSendContext();
+	WorldsWithFrameContext.Add(World);
+}
+
+void UTPSGameplayCueManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Closing the context flushes every cue raised this frame before the net driver sends
+	if (WorldsWithFrameContext.RemoveSingleSwap(World) > 0)
+	{
+		EndGameplayCueSendContext();
+	}
+}
+
+void UTPSGameplayCueManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (WorldsWithFrameContext.RemoveSingleSwap(World) > 0)
+	{
+		EndGameplayCueSendContext();
+	}
+}
+
+void UTPSGameplayCueManager::FlushPendingCues()
+{
+	TPS_SCOPE_CYCLE_COUNTER(CueFlush);
+
+	CoalescePendingExecutes();
+
+	Super::FlushPendingCues();
+}
+
+void UTPSGameplayCueManager::CoalescePendingExecutes()
+{
+	for (int32 Index = 0; Index < PendingExecuteCues.Num(); ++Index)
+	{
+		FGameplayCuePendingExecute& Target = PendingExecuteCues[Index];
+		if (Target.PayloadType != EGameplayCuePayloadType::CueParameters)
+		{
+			continue;
+		}
+
+		for (int32 OtherIndex = PendingExecuteCues.Num() - 1; OtherIndex > Index; --OtherIndex)
+		{
+			const FGameplayCuePendingExecute& Other = PendingExecuteCues[OtherIndex];
+			if (Other.PayloadType == EGameplayCuePayloadType::CueParameters && TPSGameplayCues::HaveSameParameters(Target, Other))
+			{
+				for (const FGameplayTag& Tag : Other.GameplayCueTags)
+				{
+					Target.GameplayCueTags.AddUnique(Tag);
+				}
+				PendingExecuteCues.RemoveAt(OtherIndex);
+			}
+		}
+	}
+}
+
+bool UTPSGameplayCueManager::ProcessPendingCueExecute(FGameplayCuePendingExecute& PendingCue)
+{
+	if (!Super::ProcessPendingCueExecute(PendingCue))
+	{
+		return false;
+	}
+
+	return IsWithinCullDistanceOfAnyPlayer(PendingCue);
+}
+
+bool UTPSGameplayCueManager::IsWithinCullDistanceOfAnyPlayer(const FGameplayCuePendingExecute& PendingCue) const
+{
+	const UAbilitySystemComponent* OwningComponent = PendingCue.OwningComponent;
+	if (CullDistance <= 0.0f || !OwningComponent || !OwningComponent->IsOwnerActorAuthoritative())
+	{
+		return true;
+	}
+
+	const AActor* Avatar = OwningComponent->GetAvatarActor_Direct();
+	const UWorld* World = OwningComponent->GetWorld();
+	if (!Avatar || !World)
+	{
+		return true;
+	}
+
+	FVector CueLocation = Avatar->GetActorLocation();
+	if (PendingCue.PayloadType == EGameplayCuePayloadType::CueParameters && !PendingCue.CueParameters.Location.IsZero())
+	{
+		CueLocation = PendingCue.CueParameters.Location;
+	}
+
+	const float CullDistanceSquared = FMath::Square(CullDistance);
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const AActor* ViewTarget = PlayerController ? PlayerController->GetViewTarget() : nullptr;
+		if (ViewTarget && FVector::DistSquared(ViewTarget->GetActorLocation(), CueLocation) <= CullDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayCueManager.h"
+#include "TPSGameplayCueManager.generated.h"
+
+/**
+ * Batches gameplay cue executes (fire, impacts, hit reacts) on the server:
+ * - cues raised during a frame are held in one send context and flushed once after actor tick
+ * - executes from the same ASC with the same parameters are merged into one multicast, duplicates are dropped
+ * - cues with no player within CullDistance are not replicated at all
+ */
+UCLASS(config = Game)
+class TPS_API UTPSGameplayCueManager : public UGameplayCueManager
+{
+	GENERATED_BODY()
+
+public:
+	UTPSGameplayCueManager(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// Execute cues further than this from every player are dropped before replication. 0 disables culling
+	UPROPERTY(config, EditAnywhere, Category = "Batching")
+	float CullDistance = 15000.0f;
+
+	virtual void OnCreated() override;
+	virtual void BeginDestroy() override;
+	virtual void FlushPendingCues() override;
+	virtual bool ProcessPendingCueExecute(FGameplayCuePendingExecute& PendingCue) override;
+
+private:
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// A world torn down between tick start and post actor tick would otherwise keep its send context open for good
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	// Folds executes that target the same ASC with identical parameters into a single pending cue
+	void CoalescePendingExecutes();
+
+	bool IsWithinCullDistanceOfAnyPlayer(const FGameplayCuePendingExecute& PendingCue) const;
+
+	// Worlds that currently hold a frame-long send context
+	TArray<TWeakObjectPtr<UWorld>> WorldsWithFrameContext;
+
+	FDelegateHandle TickStartHandle;
+
+	FDelegateHandle PostActorTickHandle;
+
+	FDelegateHandle WorldCleanupHandle;
+};
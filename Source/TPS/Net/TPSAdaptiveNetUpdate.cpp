@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAdaptiveNetUpdate.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "TPSStats.h"
+
+namespace TPSAdaptiveNetUpdate
+{
+	static int32 Enabled = 1;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("tps.Net.AdaptiveUpdate"),
+		Enabled,
+		TEXT("Lower the net update frequency of idle player states and characters (0: off, 1: on)."));
+}
+
+void FTPSAdaptiveNetUpdate::Bump(AActor* Owner)
+{
+	if (!Owner || !Owner->HasAuthority())
+	{
+		return;
+	}
+
+	LastActivityTime = Owner->GetWorld()->GetTimeSeconds();
+
+	// Already at full rate, the change goes out with the next regular update
+	if (Owner->NetUpdateFrequency < MaxFrequency)
+	{
+		SetFrequency(Owner, MaxFrequency);
+		Owner->ForceNetUpdate();
+	}
+}
+
+void FTPSAdaptiveNetUpdate::Update(AActor* Owner, bool bActive)
+{
+	if (!Owner || !Owner->HasAuthority())
+	{
+		return;
+	}
+
+	const double Now = Owner->GetWorld()->GetTimeSeconds();
+	const float DeltaSeconds = LastUpdateTime > 0.0 ? Now - LastUpdateTime : 0.0f;
+	LastUpdateTime = Now;
+
+	if (!TPSAdaptiveNetUpdate::Enabled)
+	{
+		SetFrequency(Owner, MaxFrequency);
+		return;
+	}
+
+	if (bActive)
+	{
+		Bump(Owner);
+		return;
+	}
+
+	if (Now - LastActivityTime < HoldSeconds || Owner->NetUpdateFrequency <= MinFrequency)
+	{
+		return;
+	}
+
+	const float Decay = FMath::Pow(0.5f, DeltaSeconds / FMath::Max(HalfLifeSeconds, UE_KINDA_SMALL_NUMBER));
+	SetFrequency(Owner, FMath::Max(Owner->NetUpdateFrequency * Decay, MinFrequency));
+}
+
+void FTPSAdaptiveNetUpdate::Reset(AActor* Owner)
+{
+	if (Owner)
+	{
+		SetFrequency(Owner, MaxFrequency);
+	}
+}
+
+void FTPSAdaptiveNetUpdate::SetFrequency(AActor* Owner, float Frequency)
+{
+	Owner->NetUpdateFrequency = Frequency;
+
+	const float NewHzSaved = MaxFrequency - Frequency;
+	UTPSAdaptiveNetUpdateSubsystem::AddHzSaved(Owner->GetWorld(), NewHzSaved - HzSaved);
+	HzSaved = NewHzSaved;
+}
+
+bool UTPSAdaptiveNetUpdateSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTPSAdaptiveNetUpdateSubsystem::AddHzSaved(const UWorld* World, float DeltaHzSaved)
+{
+	UTPSAdaptiveNetUpdateSubsystem* Subsystem = World ? World->GetSubsystem<UTPSAdaptiveNetUpdateSubsystem>() : nullptr;
+	if (!Subsystem || DeltaHzSaved == 0.0f)
+	{
+		return;
+	}
+
+	Subsystem->TotalHzSaved += DeltaHzSaved;
+
+	// Stats are process wide, they show whichever server world changed last
+	SET_FLOAT_STAT(STAT_TPS_NetHzSaved, Subsystem->TotalHzSaved);
+	CSV_CUSTOM_STAT(TPS, NetHzSaved, Subsystem->TotalHzSaved, ECsvCustomStatOp::Set);
+}
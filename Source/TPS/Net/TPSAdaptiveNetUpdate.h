@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPSAdaptiveNetUpdate.generated.h"
+
+/**
+ * Server-side NetUpdateFrequency policy for an actor that is often idle.
+ * Bump() jumps to MaxFrequency and forces an update, Update() holds it for HoldSeconds and then decays it toward
+ * MinFrequency while nothing happens, so idle or dead players stop costing the net driver a full rate of empty checks.
+ * Disabled with tps.Net.AdaptiveUpdate 0. Readout: the "Net update Hz saved" line in "stat TPS".
+ */
+USTRUCT()
+struct TPS_API FTPSAdaptiveNetUpdate
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float MaxFrequency = 100.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float MinFrequency = 2.0f;
+
+	// Seconds at MaxFrequency after the last activity
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float HoldSeconds = 1.0f;
+
+	// Time for the frequency to halve once the hold is over
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float HalfLifeSeconds = 0.5f;
+
+	// Something replicated changed, send it now and stay at full rate for a while
+	void Bump(AActor* Owner);
+
+	// Decays the frequency, bActive counts as a bump without forcing an update
+	void Update(AActor* Owner, bool bActive = false);
+
+	// Gives the owner its full rate back and removes it from the saved total
+	void Reset(AActor* Owner);
+
+private:
+	void SetFrequency(AActor* Owner, float Frequency);
+
+	double LastActivityTime = 0.0;
+
+	double LastUpdateTime = 0.0;
+
+	float HzSaved = 0.0f;
+};
+
+/**
+ * Per-world total of what FTPSAdaptiveNetUpdate saves, so PIE clients and several server worlds in one process
+ * are not summed together.
+ */
+UCLASS()
+class TPS_API UTPSAdaptiveNetUpdateSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	// Sum over every adaptive actor in this world of MaxFrequency minus the current frequency
+	float GetTotalHzSaved() const { return TotalHzSaved; }
+
+	static void AddHzSaved(const UWorld* World, float DeltaHzSaved);
+
+private:
+	float TotalHzSaved = 0.0f;
+};
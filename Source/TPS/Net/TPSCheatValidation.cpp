@@ -0,0 +1,313 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSCheatValidation.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "TPSStats.h"
+
+namespace TPSAntiCheat
+{
+	static int32 Enabled = 1;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("tps.AntiCheat.Enabled"),
+		Enabled,
+		TEXT("Validate fire rate, movement speed and aim of remote players on the server (0: off, 1: on)."));
+
+	static float ScoreThreshold = 10.0f;
+	static FAutoConsoleVariableRef CVarScoreThreshold(
+		TEXT("tps.AntiCheat.ScoreThreshold"),
+		ScoreThreshold,
+		TEXT("Violation score at which a player is reported. Scores halve every tps.AntiCheat.ScoreHalfLife seconds."));
+
+	static float ScoreHalfLife = 10.0f;
+	static FAutoConsoleVariableRef CVarScoreHalfLife(
+		TEXT("tps.AntiCheat.ScoreHalfLife"),
+		ScoreHalfLife,
+		TEXT("Seconds for a violation score to halve."));
+
+	static float MaxAimDegreesPerSecond = 3600.0f;
+	static FAutoConsoleVariableRef CVarMaxAimDegreesPerSecond(
+		TEXT("tps.AntiCheat.MaxAimDegreesPerSecond"),
+		MaxAimDegreesPerSecond,
+		TEXT("View rotation speed above which a move counts as an aim snap."));
+
+	static float MaxTimeDilation = 1.05f;
+	static FAutoConsoleVariableRef CVarMaxTimeDilation(
+		TEXT("tps.AntiCheat.MaxTimeDilation"),
+		MaxTimeDilation,
+		TEXT("Largest ratio of client move time to server time before a player counts as speed hacking."));
+
+	static int32 Kick = 0;
+	static FAutoConsoleVariableRef CVarKick(
+		TEXT("tps.AntiCheat.Kick"),
+		Kick,
+		TEXT("Kick players that reach the score threshold instead of only logging them (0: log, 1: kick)."));
+
+	// Slack for network jitter on shot cadence and server rounding on speed
+	static constexpr float ShotIntervalTolerance = 0.9f;
+	static constexpr float SpeedTolerance = 1.1f;
+
+	// Client and server clocks are compared over at least this long, short windows mistake a burst of delayed moves for a fast clock
+	static constexpr double MinTimeDilationWindow = 30.0;
+
+	// Reported players are not reported again for this long
+	static constexpr double VerdictCooldown = 30.0;
+}
+
+FTPSCheatValidator::FTPSCheatValidator()
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		Thread = FRunnableThread::Create(this, TEXT("TPSCheatValidation"), 0, TPri_BelowNormal);
+	}
+}
+
+FTPSCheatValidator::~FTPSCheatValidator()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FTPSCheatValidator::Enqueue(const FTPSCheatEvent& Event)
+{
+	Events.Enqueue(Event);
+}
+
+bool FTPSCheatValidator::DequeueVerdict(FTPSCheatVerdict& OutVerdict)
+{
+	if (!Thread)
+	{
+		ProcessEvents();
+	}
+	return Verdicts.Dequeue(OutVerdict);
+}
+
+uint32 FTPSCheatValidator::Run()
+{
+	while (!bStopping)
+	{
+		// Batching a few frames of events keeps the worker mostly asleep
+		WakeEvent->Wait(100);
+		ProcessEvents();
+	}
+	return 0;
+}
+
+void FTPSCheatValidator::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FTPSCheatValidator::ProcessEvents()
+{
+	FTPSCheatEvent Event;
+	while (Events.Dequeue(Event))
+	{
+		FPlayerHistory& History = Players.FindOrAdd(Event.PlayerId);
+		if (Event.Type == ETPSCheatEventType::Shot)
+		{
+			ScoreShot(History, Event);
+		}
+		else
+		{
+			ScoreMove(History, Event);
+		}
+	}
+}
+
+void FTPSCheatValidator::ScoreShot(FPlayerHistory& History, const FTPSCheatEvent& Event)
+{
+	double& LastShotTime = History.LastShotTimes.FindOrAdd(Event.AbilityName, -UE_BIG_NUMBER);
+	const double Interval = Event.ServerTime - LastShotTime;
+	LastShotTime = Event.ServerTime;
+
+	if (Interval < Event.MinShotInterval * TPSAntiCheat::ShotIntervalTolerance)
+	{
+		AddViolation(History, Event, 1.0f, TEXT("fire rate"));
+	}
+}
+
+void FTPSCheatValidator::ScoreMove(FPlayerHistory& History, const FTPSCheatEvent& Event)
+{
+	const double MoveDelay = Event.ServerTime - Event.ClientTimeStamp;
+
+	// The client timestamp resets now and then, start a new window when it goes backwards
+	if (History.FirstMoveServerTime == 0.0 || Event.ClientTimeStamp < History.LastClientTimeStamp)
+	{
+		History.FirstMoveServerTime = Event.ServerTime;
+		History.FirstMoveClientTimeStamp = Event.ClientTimeStamp;
+		History.LastClientTimeStamp = Event.ClientTimeStamp;
+		History.MinMoveDelay = MoveDelay;
+		History.MaxMoveDelay = MoveDelay;
+		return;
+	}
+
+	const float MoveDeltaTime = Event.ClientTimeStamp - History.LastClientTimeStamp;
+	History.LastClientTimeStamp = Event.ClientTimeStamp;
+	History.MinMoveDelay = FMath::Min(History.MinMoveDelay, MoveDelay);
+	History.MaxMoveDelay = FMath::Max(History.MaxMoveDelay, MoveDelay);
+
+	if (MoveDeltaTime > UE_KINDA_SMALL_NUMBER && Event.MaxSpeed > 0.0f && Event.ClientMoveDistance / MoveDeltaTime > Event.MaxSpeed * TPSAntiCheat::SpeedTolerance)
+	{
+		AddViolation(History, Event, 0.5f, TEXT("movement speed"));
+	}
+
+	if (MoveDeltaTime > UE_KINDA_SMALL_NUMBER && Event.AimDeltaDegrees / MoveDeltaTime > TPSAntiCheat::MaxAimDegreesPerSecond)
+	{
+		AddViolation(History, Event, 0.5f, TEXT("aim snap"));
+	}
+
+	// A speed hack runs the client clock fast, it sends more move time than the server has seen pass.
+	// Network jitter alone can make the client side look longer by at most the spread of the receive delay
+	const double ServerElapsed = Event.ServerTime - History.FirstMoveServerTime;
+	if (ServerElapsed >= TPSAntiCheat::MinTimeDilationWindow)
+	{
+		const double ClientElapsed = Event.ClientTimeStamp - History.FirstMoveClientTimeStamp;
+		const double Jitter = History.MaxMoveDelay - History.MinMoveDelay;
+		if ((ClientElapsed - Jitter) / ServerElapsed > TPSAntiCheat::MaxTimeDilation)
+		{
+			AddViolation(History, Event, 2.0f, TEXT("time dilation"));
+		}
+		History.FirstMoveServerTime = Event.ServerTime;
+		History.FirstMoveClientTimeStamp = Event.ClientTimeStamp;
+		History.MinMoveDelay = MoveDelay;
+		History.MaxMoveDelay = MoveDelay;
+	}
+}
+
+void FTPSCheatValidator::AddViolation(FPlayerHistory& History, const FTPSCheatEvent& Event, float Weight, const TCHAR* Reason)
+{
+	const double Elapsed = Event.ServerTime - History.LastScoreTime;
+	History.Score *= FMath::Pow(0.5f, static_cast<float>(Elapsed) / FMath::Max(TPSAntiCheat::ScoreHalfLife, 1.0f));
+	History.Score += Weight;
+	History.LastScoreTime = Event.ServerTime;
+
+	if (History.Score >= TPSAntiCheat::ScoreThreshold && Event.ServerTime - History.LastVerdictTime >= TPSAntiCheat::VerdictCooldown)
+	{
+		History.LastVerdictTime = Event.ServerTime;
+
+		FTPSCheatVerdict Verdict;
+		Verdict.PlayerId = Event.PlayerId;
+		Verdict.Score = History.Score;
+		Verdict.Reason = Reason;
+		Verdicts.Enqueue(MoveTemp(Verdict));
+	}
+}
+
+bool UTPSCheatValidationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client && World->GetNetMode() != NM_Standalone && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTPSCheatValidationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Validator = MakeUnique<FTPSCheatValidator>();
+}
+
+void UTPSCheatValidationSubsystem::Deinitialize()
+{
+	Validator.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UTPSCheatValidationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTPSCheatValidationSubsystem, STATGROUP_Tickables);
+}
+
+void UTPSCheatValidationSubsystem::ReportShot(const UWorld* World, const APlayerState* PlayerState, FName AbilityName, float MinShotInterval)
+{
+	if (UTPSCheatValidationSubsystem* Subsystem = World ? World->GetSubsystem<UTPSCheatValidationSubsystem>() : nullptr)
+	{
+		FTPSCheatEvent Event;
+		Event.Type = ETPSCheatEventType::Shot;
+		Event.AbilityName = AbilityName;
+		Event.MinShotInterval = MinShotInterval;
+		Subsystem->Report(PlayerState, Event);
+	}
+}
+
+void UTPSCheatValidationSubsystem::ReportMove(const UWorld* World, const APlayerState* PlayerState, float ClientTimeStamp, float ClientMoveDistance, float MaxSpeed, float AimDeltaDegrees)
+{
+	if (UTPSCheatValidationSubsystem* Subsystem = World ? World->GetSubsystem<UTPSCheatValidationSubsystem>() : nullptr)
+	{
+		FTPSCheatEvent Event;
+		Event.Type = ETPSCheatEventType::Move;
+		Event.ClientTimeStamp = ClientTimeStamp;
+		Event.ClientMoveDistance = ClientMoveDistance;
+		Event.MaxSpeed = MaxSpeed;
+		Event.AimDeltaDegrees = AimDeltaDegrees;
+		Subsystem->Report(PlayerState, Event);
+	}
+}
+
+void UTPSCheatValidationSubsystem::Report(const APlayerState* PlayerState, FTPSCheatEvent& Event)
+{
+	// Bots and the listen server host run their own input, there is nothing to validate
+	if (!TPSAntiCheat::Enabled || !PlayerState || PlayerState->IsABot())
+	{
+		return;
+	}
+
+	const APlayerController* PlayerController = PlayerState->GetPlayerController();
+	if (!PlayerController || PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	Event.PlayerId = PlayerState->GetPlayerId();
+	Event.ServerTime = FPlatformTime::Seconds();
+	Validator->Enqueue(Event);
+}
+
+void UTPSCheatValidationSubsystem::Tick(float DeltaTime)
+{
+	FTPSCheatVerdict Verdict;
+	while (Validator->DequeueVerdict(Verdict))
+	{
+		HandleVerdict(Verdict);
+	}
+}
+
+void UTPSCheatValidationSubsystem::HandleVerdict(const FTPSCheatVerdict& Verdict)
+{
+	INC_DWORD_STAT(STAT_TPS_CheatVerdicts);
+	CSV_CUSTOM_STAT(TPS, CheatVerdicts, 1, ECsvCustomStatOp::Accumulate);
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	APlayerState* const* PlayerState = GameState ? GameState->PlayerArray.FindByPredicate([&Verdict](const APlayerState* Candidate)
+	{
+		return Candidate && Candidate->GetPlayerId() == Verdict.PlayerId;
+	}) : nullptr;
+
+	const FString PlayerName = PlayerState ? (*PlayerState)->GetPlayerName() : FString::FromInt(Verdict.PlayerId);
+	UE_LOG(LogTemp, Warning, TEXT("%s() %s reached score %.1f, last violation: %s"), *FString(__FUNCTION__), *PlayerName, Verdict.Score, *Verdict.Reason);
+
+	const AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	APlayerController* PlayerController = PlayerState ? (*PlayerState)->GetPlayerController() : nullptr;
+	if (TPSAntiCheat::Kick && GameMode && GameMode->GameSession && PlayerController)
+	{
+		GameMode->GameSession->KickPlayer(PlayerController, FText::FromString(TEXT("Kicked by server validation")));
+	}
+}
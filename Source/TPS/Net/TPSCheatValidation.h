@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+#include "TPSCheatValidation.generated.h"
+
+class APlayerState;
+class FRunnableThread;
+
+enum class ETPSCheatEventType : uint8
+{
+	Shot,
+	Move,
+};
+
+// What the game thread hands to the validator, plain values only so the worker never touches UObjects
+struct FTPSCheatEvent
+{
+	ETPSCheatEventType Type = ETPSCheatEventType::Move;
+
+	int32 PlayerId = INDEX_NONE;
+
+	double ServerTime = 0.0;
+
+	// Shot: ability class name and the smallest interval its weapon data allows
+	FName AbilityName;
+
+	float MinShotInterval = 0.0f;
+
+	// Move: client timestamp, horizontal distance from the client's previous location, the speed the server allows and view rotation change
+	float ClientTimeStamp = 0.0f;
+
+	float ClientMoveDistance = 0.0f;
+
+	float MaxSpeed = 0.0f;
+
+	float AimDeltaDegrees = 0.0f;
+};
+
+struct FTPSCheatVerdict
+{
+	int32 PlayerId = INDEX_NONE;
+
+	float Score = 0.0f;
+
+	FString Reason;
+};
+
+/**
+ * Scores cheat events on a worker thread. The game thread only enqueues into a lock-free queue,
+ * all per-player history lives on the worker and verdicts come back through a second queue.
+ */
+class TPS_API FTPSCheatValidator : public FRunnable
+{
+public:
+	FTPSCheatValidator();
+	virtual ~FTPSCheatValidator() override;
+
+	void Enqueue(const FTPSCheatEvent& Event);
+
+	bool DequeueVerdict(FTPSCheatVerdict& OutVerdict);
+
+	// Runs the scoring on the calling thread, used when the platform has no threads
+	void ProcessEvents();
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FPlayerHistory
+	{
+		TMap<FName, double> LastShotTimes;
+
+		double FirstMoveServerTime = 0.0;
+
+		float FirstMoveClientTimeStamp = 0.0f;
+
+		float LastClientTimeStamp = 0.0f;
+
+		// Smallest and largest server receive time minus client timestamp in the current window, their spread is the jitter
+		double MinMoveDelay = 0.0;
+
+		double MaxMoveDelay = 0.0;
+
+		float Score = 0.0f;
+
+		double LastScoreTime = 0.0;
+
+		double LastVerdictTime = -UE_BIG_NUMBER;
+	};
+
+	void ScoreShot(FPlayerHistory& History, const FTPSCheatEvent& Event);
+
+	void ScoreMove(FPlayerHistory& History, const FTPSCheatEvent& Event);
+
+	void AddViolation(FPlayerHistory& History, const FTPSCheatEvent& Event, float Weight, const TCHAR* Reason);
+
+	TQueue<FTPSCheatEvent, EQueueMode::Mpsc> Events;
+
+	TQueue<FTPSCheatVerdict, EQueueMode::Spsc> Verdicts;
+
+	TMap<int32, FPlayerHistory> Players;
+
+	FEvent* WakeEvent = nullptr;
+
+	FRunnableThread* Thread = nullptr;
+
+	TAtomic<bool> bStopping { false };
+};
+
+/**
+ * Server-only fire rate, movement speed and aim validation.
+ * UTPSGameplayAbility reports shots and UTPSCharacterMovementComponent reports every client move, each as one enqueue.
+ * Verdicts are drained here: logged, counted in "stat TPS" and optionally kicked (tps.AntiCheat.Kick).
+ */
+UCLASS()
+class TPS_API UTPSCheatValidationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	static void ReportShot(const UWorld* World, const APlayerState* PlayerState, FName AbilityName, float MinShotInterval);
+
+	static void ReportMove(const UWorld* World, const APlayerState* PlayerState, float ClientTimeStamp, float ClientMoveDistance, float MaxSpeed, float AimDeltaDegrees);
+
+private:
+	void Report(const APlayerState* PlayerState, FTPSCheatEvent& Event);
+
+	void HandleVerdict(const FTPSCheatVerdict& Verdict);
+
+	TUniquePtr<FTPSCheatValidator> Validator;
+};
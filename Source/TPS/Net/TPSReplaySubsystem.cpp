@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSReplaySubsystem.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace TPSReplay
+{
+	// Local file streaming writes to Saved/Demos/<Name>.replay
+	static const TCHAR* StreamerOption = TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming");
+
+	static FString GetReplayFilePath(const FString& ReplayName)
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Demos"), ReplayName + TEXT(".replay"));
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdBenchmark(
+		TEXT("tps.Replay.Benchmark"),
+		TEXT("Measures replay recording overhead on the server. Usage: tps.Replay.Benchmark [SecondsPerPhase=60]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+			if (UTPSReplaySubsystem* ReplaySubsystem = GameInstance ? GameInstance->GetSubsystem<UTPSReplaySubsystem>() : nullptr)
+			{
+				ReplaySubsystem->StartBenchmark(Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 60.0f);
+			}
+		}));
+}
+
+void UTPSReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UTPSReplaySubsystem::OnPreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UTPSReplaySubsystem::OnPostLoadMap);
+}
+
+void UTPSReplaySubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FTSTicker::GetCoreTicker().RemoveTicker(BenchmarkTickerHandle);
+
+	StopRecording();
+
+	Super::Deinitialize();
+}
+
+bool UTPSReplaySubsystem::ShouldRecordMatches() const
+{
+	return bRecordMatches || FParse::Param(FCommandLine::Get(), TEXT("TPSRecordMatches"));
+}
+
+void UTPSReplaySubsystem::OnPreLoadMap(const FString& MapName)
+{
+	StopRecording();
+}
+
+void UTPSReplaySubsystem::OnPostLoadMap(UWorld* World)
+{
+	if (World && World->GetGameInstance() == GetGameInstance() && World->GetNetMode() < NM_Client && ShouldRecordMatches())
+	{
+		StartRecording();
+	}
+}
+
+void UTPSReplaySubsystem::StartRecording()
+{
+	if (IsRecording())
+	{
+		return;
+	}
+
+	CurrentReplayName = FString::Printf(TEXT("%s_%s"), *ReplayNamePrefix, *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
+	GetGameInstance()->StartRecordingReplay(CurrentReplayName, CurrentReplayName, { TPSReplay::StreamerOption });
+
+	UE_LOG(LogTemp, Log, TEXT("%s() Recording %s"), *FString(__FUNCTION__), *TPSReplay::GetReplayFilePath(CurrentReplayName));
+}
+
+bool UTPSReplaySubsystem::IsRecording() const
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	return World && World->GetDemoNetDriver() && World->GetDemoNetDriver()->IsRecording();
+}
+
+void UTPSReplaySubsystem::StopRecording()
+{
+	if (IsRecording())
+	{
+		GetGameInstance()->StopRecordingReplay();
+	}
+
+	CurrentReplayName.Reset();
+}
+
+void UTPSReplaySubsystem::StartBenchmark(float SecondsPerPhase)
+{
+	if (BenchmarkPhase != EBenchmarkPhase::None)
+	{
+		return;
+	}
+
+	bWasRecordingBeforeBenchmark = IsRecording();
+	StopRecording();
+
+	BenchmarkSecondsPerPhase = SecondsPerPhase;
+	BenchmarkPhaseTime = 0.0f;
+	BenchmarkAccumulatedMs = 0.0;
+	BenchmarkFrames = 0;
+	BenchmarkPhase = EBenchmarkPhase::NotRecording;
+	BenchmarkTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UTPSReplaySubsystem::TickBenchmark));
+
+	UE_LOG(LogTemp, Log, TEXT("%s() Sampling %.0fs without and %.0fs with recording"), *FString(__FUNCTION__), SecondsPerPhase, SecondsPerPhase);
+}
+
+bool UTPSReplaySubsystem::TickBenchmark(float DeltaTime)
+{
+	BenchmarkPhaseTime += DeltaTime;
+
+	if (BenchmarkPhase == EBenchmarkPhase::NotRecording || BenchmarkPhase == EBenchmarkPhase::Recording)
+	{
+		BenchmarkAccumulatedMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		++BenchmarkFrames;
+	}
+
+	// Finalizing only gives the streamer a moment to finish writing the file
+	const float PhaseDuration = BenchmarkPhase == EBenchmarkPhase::Finalizing ? 2.0f : BenchmarkSecondsPerPhase;
+	if (BenchmarkPhaseTime < PhaseDuration)
+	{
+		return true;
+	}
+
+	const double AverageMs = BenchmarkFrames > 0 ? BenchmarkAccumulatedMs / BenchmarkFrames : 0.0;
+	BenchmarkPhaseTime = 0.0f;
+	BenchmarkAccumulatedMs = 0.0;
+	BenchmarkFrames = 0;
+
+	switch (BenchmarkPhase)
+	{
+	case EBenchmarkPhase::NotRecording:
+		NotRecordingAverageMs = AverageMs;
+		StartRecording();
+		BenchmarkReplayName = CurrentReplayName;
+		BenchmarkPhase = EBenchmarkPhase::Recording;
+		return true;
+
+	case EBenchmarkPhase::Recording:
+	{
+		RecordingAverageMs = AverageMs;
+		const UWorld* World = GetGameInstance()->GetWorld();
+		const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+		BenchmarkNumPlayers = GameState ? GameState->PlayerArray.Num() : 0;
+		StopRecording();
+		BenchmarkPhase = EBenchmarkPhase::Finalizing;
+		return true;
+	}
+
+	case EBenchmarkPhase::Finalizing:
+	{
+		const int64 ReplayBytes = IFileManager::Get().FileSize(*TPSReplay::GetReplayFilePath(BenchmarkReplayName));
+		const double Minutes = BenchmarkSecondsPerPhase / 60.0;
+		const double MegabytesPerPlayerMinute = ReplayBytes > 0 && BenchmarkNumPlayers > 0 ? (ReplayBytes / (1024.0 * 1024.0)) / BenchmarkNumPlayers / Minutes : 0.0;
+		const double OverheadPercent = NotRecordingAverageMs > 0.0 ? (RecordingAverageMs - NotRecordingAverageMs) / NotRecordingAverageMs * 100.0 : 0.0;
+
+		UE_LOG(LogTemp, Log, TEXT("TPSReplay benchmark: players=%d frame=%.3fms recording=%.3fms overhead=%.1f%% size=%lldB %.3fMB/player/min"),
+			BenchmarkNumPlayers, NotRecordingAverageMs, RecordingAverageMs, OverheadPercent, ReplayBytes, MegabytesPerPlayerMinute);
+
+		BenchmarkPhase = EBenchmarkPhase::None;
+		if (bWasRecordingBeforeBenchmark)
+		{
+			StartRecording();
+		}
+		return false;
+	}
+
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "TPSReplaySubsystem.generated.h"
+
+/**
+ * Records every match on the server to a local replay file for later review.
+ * Recording rates, checkpoint interval and delta checkpoints are set through the demo.* console variables
+ * in DefaultEngine.ini. "tps.Replay.Benchmark [Seconds]" measures the recording overhead.
+ */
+UCLASS(config = Game)
+class TPS_API UTPSReplaySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Record every map the server loads. Also enabled with -TPSRecordMatches
+	UPROPERTY(config)
+	bool bRecordMatches = false;
+
+	UPROPERTY(config)
+	FString ReplayNamePrefix = TEXT("Match");
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void StartRecording();
+
+	void StopRecording();
+
+	// Asks the demo net driver, a failed start or a map change can end the recording without StopRecording
+	bool IsRecording() const;
+
+	// Compares server frame time with recording off and on, then reports the replay size per player per minute
+	void StartBenchmark(float SecondsPerPhase);
+
+private:
+	bool ShouldRecordMatches() const;
+
+	void OnPreLoadMap(const FString& MapName);
+
+	void OnPostLoadMap(UWorld* World);
+
+	bool TickBenchmark(float DeltaTime);
+
+	enum class EBenchmarkPhase : uint8
+	{
+		None,
+		NotRecording,
+		Recording,
+		Finalizing
+	};
+
+	FString CurrentReplayName;
+
+	EBenchmarkPhase BenchmarkPhase = EBenchmarkPhase::None;
+
+	FTSTicker::FDelegateHandle BenchmarkTickerHandle;
+
+	float BenchmarkSecondsPerPhase = 0.0f;
+
+	float BenchmarkPhaseTime = 0.0f;
+
+	double BenchmarkAccumulatedMs = 0.0;
+
+	int32 BenchmarkFrames = 0;
+
+	double NotRecordingAverageMs = 0.0;
+
+	double RecordingAverageMs = 0.0;
+
+	int32 BenchmarkNumPlayers = 0;
+
+	FString BenchmarkReplayName;
+
+	bool bWasRecordingBeforeBenchmark = false;
+};
@@ -0,0 +1,243 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSSignificanceManager.h"
+#include "TPSCharacter.h"
+#include "Animation/TPSAnimationBudgetSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "TPSStats.h"
+
+const FName UTPSSignificanceManager::CharacterTag(TEXT("TPSCharacter"));
+
+UTPSSignificanceManager::UTPSSignificanceManager()
+{
+	// Dedicated servers have no view to measure significance against
+	bCreateOnServer = false;
+	bCreateOnClient = true;
+
+	// Near: full rate
+	FTPSSignificanceTier Near;
+	Near.MaxDistance = 2500.0f;
+	Tiers.Add(Near);
+
+	// Mid: anim and attachments at 30 Hz, linear smoothing
+	FTPSSignificanceTier Mid;
+	Mid.MaxDistance = 6000.0f;
+	Mid.ActorTickInterval = 1.0f / 30.0f;
+	Mid.AnimTickInterval = 1.0f / 30.0f;
+	Mid.NetworkSmoothingMode = ENetworkSmoothingMode::Linear;
+	Mid.VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	Tiers.Add(Mid);
+
+	// Far: 15 Hz movement, 10 Hz anim, pose only when rendered
+	FTPSSignificanceTier Far;
+	Far.MaxDistance = 12000.0f;
+	Far.ActorTickInterval = 0.1f;
+	Far.MovementTickInterval = 1.0f / 15.0f;
+	Far.AnimTickInterval = 0.1f;
+	Far.NetworkSmoothingMode = ENetworkSmoothingMode::Linear;
+	Far.VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	Tiers.Add(Far);
+
+	// Beyond far or offscreen at distance: minimal updates, no smoothing
+	FTPSSignificanceTier Minimal;
+	Minimal.MaxDistance = TNumericLimits<float>::Max();
+	Minimal.ActorTickInterval = 0.25f;
+	Minimal.MovementTickInterval = 0.1f;
+	Minimal.AnimTickInterval = 0.25f;
+	Minimal.NetworkSmoothingMode = ENetworkSmoothingMode::Disabled;
+	Minimal.VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	Tiers.Add(Minimal);
+}
+
+void UTPSSignificanceManager::RegisterCharacter(ATPSCharacter* Character)
+{
+	if (!IsValid(Character) || Tiers.Num() == 0)
+	{
+		return;
+	}
+
+	FOriginalSettings& Original = OriginalSettings.FindOrAdd(Character);
+	Original.Settings.ActorTickInterval = Character->GetActorTickInterval();
+	if (const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		Original.Settings.MovementTickInterval = Movement->GetComponentTickInterval();
+		Original.Settings.NetworkSmoothingMode = Movement->NetworkSmoothingMode;
+	}
+	if (const USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		Original.Settings.AnimTickInterval = Mesh->GetComponentTickInterval();
+		Original.Settings.VisibilityBasedAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+	}
+
+	TArray<AActor*> AttachedActors;
+	Character->GetAttachedActors(AttachedActors);
+	Original.AttachedTickIntervals.Reset();
+	for (AActor* Attached : AttachedActors)
+	{
+		Original.AttachedTickIntervals.Add(Attached, Attached->GetActorTickInterval());
+	}
+
+	RegisterObject(Character, CharacterTag,
+		[this](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint)
+		{
+			return CalculateSignificance(ObjectInfo, Viewpoint);
+		},
+		USignificanceManager::EPostSignificanceType::Sequential,
+		[this](USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal)
+		{
+			ApplySignificance(ObjectInfo, OldSignificance, Significance, bFinal);
+		});
+}
+
+void UTPSSignificanceManager::UnregisterCharacter(ATPSCharacter* Character)
+{
+	if (!Character)
+	{
+		return;
+	}
+
+	UnregisterObject(Character);
+
+	// Give the character the update rates it was authored with back, it may have become locally controlled
+	FOriginalSettings Original;
+	if (!OriginalSettings.RemoveAndCopyValue(Character, Original))
+	{
+		return;
+	}
+
+	ApplyTier(Character, Original.Settings);
+
+	// Attachments picked up while registered go back to their class default
+	TArray<AActor*> AttachedActors;
+	Character->GetAttachedActors(AttachedActors);
+	for (AActor* Attached : AttachedActors)
+	{
+		const float* TickInterval = Original.AttachedTickIntervals.Find(Attached);
+		Attached->SetActorTickInterval(TickInterval ? *TickInterval : Attached->GetClass()->GetDefaultObject<AActor>()->GetActorTickInterval());
+	}
+}
+
+void UTPSSignificanceManager::UpdateFromLocalPlayers()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Viewpoints.Emplace(ViewRotation, ViewLocation);
+		}
+	}
+
+	if (Viewpoints.Num() > 0)
+	{
+		TPS_SCOPE_CYCLE_COUNTER(Significance);
+		Update(Viewpoints);
+	}
+}
+
+float UTPSSignificanceManager::CalculateSignificance(USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) const
+{
+	const AActor* Actor = Cast<AActor>(ObjectInfo->GetObject());
+	if (!Actor)
+	{
+		return 0.0f;
+	}
+
+	const float Distance = FVector::Dist(Actor->GetActorLocation(), Viewpoint.GetLocation());
+
+	int32 TierIndex = Tiers.Num() - 1;
+	for (int32 Index = 0; Index < Tiers.Num(); ++Index)
+	{
+		if (Distance <= Tiers[Index].MaxDistance)
+		{
+			TierIndex = Index;
+			break;
+		}
+	}
+
+	if (!Actor->WasRecentlyRendered(OffscreenTimeout))
+	{
+		TierIndex = FMath::Min(TierIndex + 1, Tiers.Num() - 1);
+	}
+
+	// Higher significance is more important, so the nearest tier gets the largest value
+	return static_cast<float>(Tiers.Num() - TierIndex);
+}
+
+void UTPSSignificanceManager::ApplySignificance(USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal)
+{
+	if (OldSignificance == Significance)
+	{
+		return;
+	}
+
+	ACharacter* Character = Cast<ACharacter>(ObjectInfo->GetObject());
+	if (!Character)
+	{
+		return;
+	}
+
+	ApplyTier(Character, Tiers[GetTierIndex(Significance)]);
+}
+
+void UTPSSignificanceManager::ReapplyTiers()
+{
+	if (Tiers.Num() == 0)
+	{
+		return;
+	}
+
+	for (const USignificanceManager::FManagedObjectInfo* ObjectInfo : GetManagedObjects(CharacterTag))
+	{
+		if (ACharacter* Character = Cast<ACharacter>(ObjectInfo->GetObject()))
+		{
+			ApplyTier(Character, Tiers[GetTierIndex(ObjectInfo->GetSignificance())]);
+		}
+	}
+}
+
+int32 UTPSSignificanceManager::GetTierIndex(float Significance) const
+{
+	return FMath::Clamp(Tiers.Num() - FMath::RoundToInt32(Significance), 0, Tiers.Num() - 1);
+}
+
+void UTPSSignificanceManager::ApplyTier(ACharacter* Character, const FTPSSignificanceTier& Tier) const
+{
+	Character->SetActorTickInterval(Tier.ActorTickInterval);
+
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(Tier.MovementTickInterval);
+		Movement->NetworkSmoothingMode = Tier.NetworkSmoothingMode;
+	}
+
+	// The animation budget allocator owns the mesh tick rate while it is enabled
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+	if (Mesh && !UTPSAnimationBudgetSubsystem::IsBudgeting(Character->GetWorld()))
+	{
+		Mesh->SetComponentTickInterval(Tier.AnimTickInterval);
+		Mesh->VisibilityBasedAnimTickOption = Tier.VisibilityBasedAnimTickOption;
+	}
+
+	// Weapons and other attachments follow the owner's rate
+	TArray<AActor*> AttachedActors;
+	Character->GetAttachedActors(AttachedActors);
+	for (AActor* Attached : AttachedActors)
+	{
+		Attached->SetActorTickInterval(Tier.ActorTickInterval);
+	}
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SignificanceManager.h"
+#include "GameFramework/Character.h"
+#include "TPSSignificanceManager.generated.h"
+
+class ATPSCharacter;
+
+/**
+ * Settings applied to a remote character while it sits in a significance tier.
+ * Tiers are ordered from most to least significant.
+ */
+USTRUCT(BlueprintType)
+struct FTPSSignificanceTier
+{
+	GENERATED_BODY()
+
+	// Characters closer than this distance (in cm) fall into this tier
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	float MaxDistance = 0.0f;
+
+	// Tick interval of the actor and of the actors attached to it (weapons). 0 ticks every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	float ActorTickInterval = 0.0f;
+
+	// Tick interval of the character movement component. 0 ticks every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	float MovementTickInterval = 0.0f;
+
+	// Tick interval of the skeletal mesh, which drives the anim blueprint update rate. 0 ticks every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	float AnimTickInterval = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	ENetworkSmoothingMode NetworkSmoothingMode = ENetworkSmoothingMode::Exponential;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	EVisibilityBasedAnimTickOption VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+};
+
+/**
+ * Scales the per-frame cost of remote characters on clients by distance to the local view and visibility.
+ * Locally controlled characters are never registered and keep their full update rate.
+ */
+UCLASS(config = Game)
+class TPS_API UTPSSignificanceManager : public USignificanceManager
+{
+	GENERATED_BODY()
+
+public:
+	UTPSSignificanceManager();
+
+	static const FName CharacterTag;
+
+	// Characters not rendered for this long (in seconds) are treated as offscreen and dropped one tier
+	UPROPERTY(config, EditAnywhere, Category = "Significance")
+	float OffscreenTimeout = 0.5f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Significance")
+	TArray<FTPSSignificanceTier> Tiers;
+
+	void RegisterCharacter(ATPSCharacter* Character);
+
+	// Restores the tick intervals, smoothing and anim tick option the character had when it was registered
+	void UnregisterCharacter(ATPSCharacter* Character);
+
+	// Refreshes significance from the viewpoints of every local player in the world
+	void UpdateFromLocalPlayers();
+
+	// Applies the current tier of every registered character again, e.g. after the animation budget releases the meshes
+	void ReapplyTiers();
+
+private:
+	float CalculateSignificance(USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) const;
+
+	void ApplySignificance(USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal);
+
+	void ApplyTier(ACharacter* Character, const FTPSSignificanceTier& Tier) const;
+
+	int32 GetTierIndex(float Significance) const;
+
+	TArray<FTransform> Viewpoints;
+
+	// What a character had before its first tier was applied, restored when it is unregistered
+	struct FOriginalSettings
+	{
+		FTPSSignificanceTier Settings;
+
+		TMap<TWeakObjectPtr<AActor>, float> AttachedTickIntervals;
+	};
+
+	TMap<TWeakObjectPtr<ACharacter>, FOriginalSettings> OriginalSettings;
+};
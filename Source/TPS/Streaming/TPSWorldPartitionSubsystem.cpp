@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSWorldPartitionSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "TimerManager.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+#include "WorldPartition/DataLayer/DataLayerManager.h"
+
+namespace TPSWorldPartition
+{
+	// Process startup is only measured up to the first world, later worlds came from map travel
+	static bool bFirstWorldBegunPlay = false;
+
+	static FAutoConsoleCommandWithWorld CmdReport(
+		TEXT("tps.WP.Report"),
+		TEXT("Logs process memory, load time and loaded World Partition cells of the current world."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UTPSWorldPartitionSubsystem* Subsystem = World ? World->GetSubsystem<UTPSWorldPartitionSubsystem>() : nullptr)
+			{
+				Subsystem->LogReport();
+			}
+		}));
+}
+
+bool UTPSWorldPartitionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTPSWorldPartitionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	BeginPlayTime = FPlatformTime::Seconds();
+	bIsFirstWorld = !TPSWorldPartition::bFirstWorldBegunPlay;
+	TPSWorldPartition::bFirstWorldBegunPlay = true;
+
+	if (InWorld.GetWorldPartition())
+	{
+		ApplyDataLayerPolicy();
+	}
+
+	// Every dedicated server logs where it started once, to compare the TPSServer target with TPS -server
+	if (bIsFirstWorld && InWorld.GetNetMode() == NM_DedicatedServer)
+	{
+		LogReport();
+	}
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("TPSStreamingBenchmark")) || FParse::Param(FCommandLine::Get(), TEXT("TPSStreamingBenchmarkQuit")))
+	{
+		InWorld.GetTimerManager().SetTimer(BenchmarkTimerHandle, this, &UTPSWorldPartitionSubsystem::FinishBenchmark, FMath::Max(BenchmarkSettleSeconds, 0.1f), false);
+	}
+}
+
+void UTPSWorldPartitionSubsystem::ApplyDataLayerPolicy()
+{
+	UDataLayerManager* DataLayerManager = UDataLayerManager::GetDataLayerManager(GetWorld());
+	if (!DataLayerManager)
+	{
+		return;
+	}
+
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+
+	// Server-only layers follow the authority, their state replicates to clients that filter them out anyway
+	if (NetMode != NM_Client)
+	{
+		for (const TSoftObjectPtr<UDataLayerAsset>& DataLayer : ServerOnlyDataLayers)
+		{
+			if (const UDataLayerAsset* DataLayerAsset = DataLayer.LoadSynchronous())
+			{
+				DataLayerManager->SetDataLayerRuntimeState(DataLayerAsset, EDataLayerRuntimeState::Activated);
+			}
+		}
+	}
+
+	// Client-only layers are activated locally by whoever renders, never by a dedicated server
+	if (NetMode != NM_DedicatedServer)
+	{
+		for (const TSoftObjectPtr<UDataLayerAsset>& DataLayer : ClientOnlyDataLayers)
+		{
+			if (const UDataLayerAsset* DataLayerAsset = DataLayer.LoadSynchronous())
+			{
+				DataLayerManager->SetDataLayerRuntimeState(DataLayerAsset, EDataLayerRuntimeState::Activated);
+			}
+		}
+	}
+}
+
+void UTPSWorldPartitionSubsystem::LogReport() const
+{
+	const UWorld* World = GetWorld();
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	int32 NumLoadedLevels = 0;
+	for (const ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel && StreamingLevel->IsLevelLoaded())
+		{
+			++NumLoadedLevels;
+		}
+	}
+
+	// Startup time only means something for the first map, which is what a headless benchmark run measures
+	const FString Startup = bIsFirstWorld && BeginPlayTime > 0.0 ? FString::Printf(TEXT("%.2fs"), BeginPlayTime - GStartTime) : FString(TEXT("n/a"));
+
+	UE_LOG(LogTemp, Log, TEXT("TPSWorldPartition report: map=%s netmode=%d partitioned=%d startup=%s rss=%.1fMB peak=%.1fMB loadedCells=%d/%d actors=%d"),
+		*World->GetMapName(), static_cast<int32>(World->GetNetMode()), World->GetWorldPartition() != nullptr, *Startup,
+		MemoryStats.UsedPhysical / (1024.0 * 1024.0), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0),
+		NumLoadedLevels, World->GetStreamingLevels().Num(), World->GetActorCount());
+}
+
+void UTPSWorldPartitionSubsystem::FinishBenchmark()
+{
+	LogReport();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("TPSStreamingBenchmarkQuit")))
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
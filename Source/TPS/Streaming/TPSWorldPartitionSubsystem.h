@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TPSWorldPartitionSubsystem.generated.h"
+
+class UDataLayerAsset;
+
+/**
+ * World Partition policy for TPS maps.
+ * Server-only data layers are activated where the game runs authoritative, client-only (cosmetic) layers only where it renders,
+ * so a dedicated server never loads them. Both need the matching Load Filter on their data layer instance in the map.
+ * "tps.WP.Report" logs memory, load time and loaded cells. -TPSStreamingBenchmark logs the same once streaming settled,
+ * and -TPSStreamingBenchmarkQuit exits afterwards for scripted headless runs.
+ */
+UCLASS(config = Game)
+class TPS_API UTPSWorldPartitionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(config)
+	TArray<TSoftObjectPtr<UDataLayerAsset>> ServerOnlyDataLayers;
+
+	UPROPERTY(config)
+	TArray<TSoftObjectPtr<UDataLayerAsset>> ClientOnlyDataLayers;
+
+	// Seconds after begin play before the benchmark samples, so server streaming has loaded around every player
+	UPROPERTY(config)
+	float BenchmarkSettleSeconds = 10.0f;
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	void LogReport() const;
+
+private:
+	void ApplyDataLayerPolicy();
+
+	void FinishBenchmark();
+
+	double BeginPlayTime = 0.0;
+
+	// Only the first world to begin play in the process reports a startup time
+	bool bIsFirstWorld = false;
+
+	FTimerHandle BenchmarkTimerHandle;
+};
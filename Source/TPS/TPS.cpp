@@ -1,7 +1,32 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TPS.h"
+#include "TPSStats.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, TPS, "TPS" );
- 
\ No newline at end of file
+
+DEFINE_STAT(STAT_TPS_Input);
+DEFINE_STAT(STAT_TPS_ASCInit);
+DEFINE_STAT(STAT_TPS_InitializeAttributes);
+DEFINE_STAT(STAT_TPS_AddAbilities);
+DEFINE_STAT(STAT_TPS_Movement);
+DEFINE_STAT(STAT_TPS_AttributeBroadcast);
+DEFINE_STAT(STAT_TPS_AbilityActivation);
+DEFINE_STAT(STAT_TPS_Significance);
+DEFINE_STAT(STAT_TPS_Bots);
+DEFINE_STAT(STAT_TPS_CueFlush);
+DEFINE_STAT(STAT_TPS_ServerMetrics);
+DEFINE_STAT(STAT_TPS_DamageApplications);
+DEFINE_STAT(STAT_TPS_ASCTimeToReadyMs);
+DEFINE_STAT(STAT_TPS_ASCInitsSkipped);
+DEFINE_STAT(STAT_TPS_NetHzSaved);
+DEFINE_STAT(STAT_TPS_PredictedHits);
+DEFINE_STAT(STAT_TPS_ConfirmedHits);
+DEFINE_STAT(STAT_TPS_RolledBackHits);
+DEFINE_STAT(STAT_TPS_CheatVerdicts);
+DEFINE_STAT(STAT_TPS_FirstUseLoads);
+
+CSV_DEFINE_CATEGORY_MODULE(TPS_API, TPS, true);
+
+UE_TRACE_CHANNEL_DEFINE(TPSChannel);
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSAssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "TPSStats.h"
+
+const FPrimaryAssetType UTPSAssetManager::LoadoutType(TEXT("TPSLoadout"));
+const FPrimaryAssetType UTPSAssetManager::AbilityType(TEXT("TPSAbility"));
+const FName UTPSAssetManager::LoadoutBundle(TEXT("Loadout"));
+
+static FAutoConsoleCommand CmdReportFirstUseLoads(
+	TEXT("tps.Assets.ReportFirstUseLoads"),
+	TEXT("Logs the packages that were loaded synchronously during play after the loadout preload."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UTPSAssetManager::Get().LogFirstUseLoads();
+	}));
+
+UTPSAssetManager& UTPSAssetManager::Get()
+{
+	check(GEngine);
+
+	UTPSAssetManager* AssetManager = Cast<UTPSAssetManager>(GEngine->AssetManager);
+	if (!AssetManager)
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("%s() Invalid AssetManagerClassName in DefaultEngine.ini, it must be TPSAssetManager"), *FString(__FUNCTION__));
+	}
+
+	return *AssetManager;
+}
+
+void UTPSAssetManager::StartInitialLoading()
+{
+	Super::StartInitialLoading();
+
+	FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UTPSAssetManager::OnPreLoadMap);
+	FCoreUObjectDelegates::OnSyncLoadPackage.AddUObject(this, &UTPSAssetManager::OnSyncLoadPackage);
+
+	PreloadLoadouts();
+}
+
+void UTPSAssetManager::FinishDestroy()
+{
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+	FCoreUObjectDelegates::OnSyncLoadPackage.RemoveAll(this);
+
+	Super::FinishDestroy();
+}
+
+void UTPSAssetManager::PreloadLoadouts()
+{
+	// Handles are kept alive so the preloaded assets are never unloaded between matches
+	if (!LoadoutHandle.IsValid())
+	{
+		LoadoutHandle = LoadPrimaryAssetsWithType(LoadoutType, { LoadoutBundle });
+	}
+
+	if (!AbilityHandle.IsValid())
+	{
+		AbilityHandle = LoadPrimaryAssetsWithType(AbilityType);
+	}
+}
+
+bool UTPSAssetManager::IsPreloadComplete() const
+{
+	const bool bLoadoutsDone = !LoadoutHandle.IsValid() || LoadoutHandle->HasLoadCompleted();
+	const bool bAbilitiesDone = !AbilityHandle.IsValid() || AbilityHandle->HasLoadCompleted();
+	return bLoadoutsDone && bAbilitiesDone;
+}
+
+void UTPSAssetManager::LogFirstUseLoads() const
+{
+	UE_LOG(LogTemp, Log, TEXT("%s() %d first-use synchronous loads"), *FString(__FUNCTION__), NumFirstUseLoads);
+	for (const FString& PackageName : FirstUseLoadedPackages)
+	{
+		UE_LOG(LogTemp, Log, TEXT("    %s"), *PackageName);
+	}
+}
+
+void UTPSAssetManager::OnPreLoadMap(const FString& MapName)
+{
+	// Travel keeps the loading screen up until the map is loaded, make sure the loadout finishes behind it
+	PreloadLoadouts();
+
+	if (LoadoutHandle.IsValid())
+	{
+		LoadoutHandle->WaitUntilComplete();
+	}
+	if (AbilityHandle.IsValid())
+	{
+		AbilityHandle->WaitUntilComplete();
+	}
+}
+
+void UTPSAssetManager::OnSyncLoadPackage(const FString& PackageName)
+{
+	// Map loads and anything before the preload finished are expected, only loads during play are hitches
+	if (!IsPreloadComplete() || !GEngine || !PackageName.StartsWith(TEXT("/Game/")))
+	{
+		return;
+	}
+
+	bool bInPlay = false;
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		const UWorld* World = Context.World();
+		if (World && World->IsGameWorld() && World->HasBegunPlay())
+		{
+			bInPlay = true;
+			break;
+		}
+	}
+
+	if (!bInPlay)
+	{
+		return;
+	}
+
+	++NumFirstUseLoads;
+	INC_DWORD_STAT(STAT_TPS_FirstUseLoads);
+	FirstUseLoadedPackages.AddUnique(PackageName);
+	UE_LOG(LogTemp, Warning, TEXT("%s() First-use synchronous load of %s, add it to a loadout"), *FString(__FUNCTION__), *PackageName);
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetManager.h"
+#include "TPSAssetManager.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * Declares the TPS primary asset types and preloads the loadout (weapons, abilities, effects, FX and sounds)
+ * while the map is loading, so nothing has to be loaded synchronously the first time it is used.
+ * Synchronous loads that still happen during play are counted as first-use loads.
+ */
+UCLASS()
+class TPS_API UTPSAssetManager : public UAssetManager
+{
+	GENERATED_BODY()
+
+public:
+	static const FPrimaryAssetType LoadoutType;
+	static const FPrimaryAssetType AbilityType;
+	static const FName LoadoutBundle;
+
+	static UTPSAssetManager& Get();
+
+	virtual void StartInitialLoading() override;
+	virtual void FinishDestroy() override;
+
+	// Starts async loading of every loadout with its bundle and every ability. Safe to call repeatedly
+	void PreloadLoadouts();
+
+	bool IsPreloadComplete() const;
+
+	int32 GetNumFirstUseLoads() const { return NumFirstUseLoads; }
+
+	void LogFirstUseLoads() const;
+
+private:
+	void OnPreLoadMap(const FString& MapName);
+
+	void OnSyncLoadPackage(const FString& PackageName);
+
+	TSharedPtr<FStreamableHandle> LoadoutHandle;
+
+	TSharedPtr<FStreamableHandle> AbilityHandle;
+
+	int32 NumFirstUseLoads = 0;
+
+	TArray<FString> FirstUseLoadedPackages;
+};
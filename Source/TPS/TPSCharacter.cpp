@@ -15,13 +15,20 @@
 #include "TPSCharacterMovementComponent.h"
 #include "TPS.h"
 #include "AbilitySystemComponent.h"
+#include "Significance/TPSSignificanceManager.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "AI/TPSAIController.h"
+#include "TPSPlayerController.h"
+#include "TPSStats.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
 //////////////////////////////////////////////////////////////////////////
 // ATPSCharacter
 
-ATPSCharacter::ATPSCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer.SetDefaultSubobjectClass<UTPSCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
+ATPSCharacter::ATPSCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer
+	.SetDefaultSubobjectClass<UTPSCharacterMovementComponent>(ACharacter::CharacterMovementComponentName)
+	.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -49,11 +56,32 @@ ATPSCharacter::ATPSCharacter(const FObjectInitializer& ObjectInitializer) : Supe
 	CameraBoom->SetupAttachment(RootComponent);
 	CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
 	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	// ATPSPlayerCameraManager places the camera from these settings, the arm itself never ticks or traces
+	CameraBoom->bDoCollisionTest = false;
+	CameraBoom->PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	// Create a follow camera
 	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+#if UE_SERVER
+	// Blueprints and abilities still read the boom and camera on the server, they just never need to do anything there
+	FollowCamera->bAutoActivate = false;
+	FollowCamera->PrimaryComponentTick.bCanEverTick = false;
+#endif // UE_SERVER
+
+	// Without this the allocator never asks UTPSAnimationBudgetSubsystem::CalculateSignificance and treats every mesh alike
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoCalculateSignificance(true);
+	}
+
+	// Simulated proxies of a standing character only need occasional updates
+	AdaptiveNetUpdate.MinFrequency = 10.0f;
+	NetUpdateFrequency = AdaptiveNetUpdate.MaxFrequency;
+
+	// Bots get their ASC from the lightweight player state their controller spawns
+	AIControllerClass = ATPSAIController::StaticClass();
 
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
@@ -67,18 +95,19 @@ bool ATPSCharacter::IsAlive() const
 void ATPSCharacter::PossessedBy(AController* NewController)
 {
 	Super::PossessedBy(NewController);
+
+	TPS_SCOPE_CYCLE_COUNTER(ASCInit);
 	
 	ATPSPlayerState* PS = GetPlayerState<ATPSPlayerState>();
 	if (PS)
 	{
 		// Set the ASC on the Server. Clients do this in OnRep_PlayerState()
-		AbilitySystemComponent = Cast<UAbilitySystemComponent>(PS->GetAbilitySystemComponent());
-
-		// AI won't have PlayerControllers so we can init again here just to be sure
-		PS->GetAbilitySystemComponent()->InitAbilityActorInfo(PS, this);
+		InitAbilityActorInfo(PS);
 
 		InitializeAttributes(PS);
 		AddCharacerAbilities();
+
+		CheckAbilitySystemReady();
 	}
 	
 }
@@ -87,18 +116,20 @@ void ATPSCharacter::OnRep_PlayerState()
 {
 	Super::OnRep_PlayerState();
 
+	TPS_SCOPE_CYCLE_COUNTER(ASCInit);
+
 	ATPSPlayerState* PS = GetPlayerState<ATPSPlayerState>();
 	if (PS)
 	{
-		// Set the ASC for clients. Server does this in PossessedBy.
-		AbilitySystemComponent = Cast<UAbilitySystemComponent>(PS->GetAbilitySystemComponent());
-
 		// Init ASC Actor Info for clients. Server will init its ASC when it possesses a new Actor.
-		AbilitySystemComponent->InitAbilityActorInfo(PS, this);
+		// This fires again for the same player state, in which case only the pieces still missing are done
+		InitAbilityActorInfo(PS);
 
 		InitializeAttributes(PS);
 
 		BindASCInput();
+
+		CheckAbilitySystemReady();
 	}
 	
 }
@@ -110,6 +141,8 @@ void ATPSCharacter::AddCharacerAbilities()
 		return;
 	}
 
+	TPS_SCOPE_CYCLE_COUNTER(AddAbilities);
+
 	for (TSubclassOf<UTPSGameplayAbility>& StartupAbility : CharacterAbilities)
 	{
 		AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec(StartupAbility, 1, static_cast<int32>(StartupAbility.GetDefaultObject()->AbilityInputID), this));
@@ -120,14 +153,52 @@ void ATPSCharacter::AddCharacerAbilities()
 
 void ATPSCharacter::BindASCInput()
 {
+	// Called from both OnRep_PlayerState and SetupPlayerInputComponent, whichever comes second does the binding
 	if (!ASCInputBound && AbilitySystemComponent.IsValid() && IsValid(InputComponent))
 	{
-		FTopLevelAssetPath AbilityEnumAssetPath = FTopLevelAssetPath(FName("/Script/TPS"), FName("EAbilityInputID"));
+		static const FTopLevelAssetPath AbilityEnumAssetPath = FTopLevelAssetPath(FName("/Script/TPS"), FName("EAbilityInputID"));
 		AbilitySystemComponent->BindAbilityActivationToInputComponent(InputComponent, FGameplayAbilityInputBinds(FString("ConfirmTarget"),
 			FString("CancelTarget"), AbilityEnumAssetPath, static_cast<int32>(EAbilityInputID::Confirm), static_cast<int32>(EAbilityInputID::Cancel)));
 
 		ASCInputBound = true;
+		CheckAbilitySystemReady();
+	}
+}
+
+bool ATPSCharacter::InitAbilityActorInfo(ATPSPlayerState* PS)
+{
+	UAbilitySystemComponent* PlayerStateASC = PS->GetAbilitySystemComponent();
+	AbilitySystemComponent = PlayerStateASC;
+
+	if (PlayerStateASC->GetOwnerActor() == PS && PlayerStateASC->GetAvatarActor_Direct() == this)
+	{
+		INC_DWORD_STAT(STAT_TPS_ASCInitsSkipped);
+		return false;
 	}
+
+	PlayerStateASC->InitAbilityActorInfo(PS, this);
+	return true;
+}
+
+void ATPSCharacter::CheckAbilitySystemReady()
+{
+	if (AbilitySystemReady || !AbilitySystemComponent.IsValid() || !AttributesInitializedFor.IsValid())
+	{
+		return;
+	}
+
+	// The local player is only ready once ability input works
+	if (IsLocallyControlled() && IsPlayerControlled() && !ASCInputBound)
+	{
+		return;
+	}
+
+	AbilitySystemReady = true;
+
+	const float TimeToReadyMs = (FPlatformTime::Seconds() - AbilitySystemInitStartTime) * 1000.0;
+	SET_FLOAT_STAT(STAT_TPS_ASCTimeToReadyMs, TimeToReadyMs);
+	CSV_CUSTOM_STAT(TPS, ASCTimeToReadyMs, TimeToReadyMs, ECsvCustomStatOp::Set);
+	UE_LOG(LogTemplateCharacter, Log, TEXT("%s() %s ready in %.1f ms"), *FString(__FUNCTION__), *GetName(), TimeToReadyMs);
 }
 
 void ATPSCharacter::InitializeAttributes(ATPSPlayerState* PS)
@@ -136,13 +207,30 @@ void ATPSCharacter::InitializeAttributes(ATPSPlayerState* PS)
 	{
 		return;
 	}
+
+	// The server initializes again for every new character, a client only once per player state
+	if (AttributesInitializedFor == PS)
+	{
+		INC_DWORD_STAT(STAT_TPS_ASCInitsSkipped);
+		return;
+	}
+
+	TPS_SCOPE_CYCLE_COUNTER(InitializeAttributes);
+
 	if (!DefaultAttributes)
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s() Missing DefaultAttributes for %s. Please fill in the characers blueprint."), *FString(__FUNCTION__), *GetName());
 	}
 
 	AttributeSet = PS->GetCharacterAttributeSet();
+	AttributesInitializedFor = PS;
 
+	// Late joiners receive the server's attributes with the player state, applying the defaults locally would only be overwritten
+	if (GetLocalRole() != ROLE_Authority && AttributeSet->GetHealth() > 0.0f)
+	{
+		INC_DWORD_STAT(STAT_TPS_ASCInitsSkipped);
+		return;
+	}
 
 	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
 	EffectContext.AddSourceObject(this);
@@ -155,10 +243,92 @@ void ATPSCharacter::InitializeAttributes(ATPSPlayerState* PS)
 	}
 }
 
+void ATPSCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	AbilitySystemInitStartTime = FPlatformTime::Seconds();
+}
+
 void ATPSCharacter::BeginPlay()
 {
 	// Call the base class  
 	Super::BeginPlay();
+
+	UpdateForLocalControl();
+}
+
+void ATPSCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (SignificanceRegistered)
+	{
+		if (UTPSSignificanceManager* SignificanceManager = USignificanceManager::Get<UTPSSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->UnregisterCharacter(this);
+		}
+		SignificanceRegistered = false;
+	}
+
+	// Clients must not write NetUpdateFrequency, the server owns it
+	if (HasAuthority())
+	{
+		AdaptiveNetUpdate.Reset(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATPSCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	if (HasActorBegunPlay())
+	{
+		UpdateForLocalControl();
+	}
+}
+
+void ATPSCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (HasAuthority())
+	{
+		const FRotator Rotation = GetControlRotation();
+		const bool bActive = !GetVelocity().IsNearlyZero() || GetCharacterMovement()->IsFalling() || !Rotation.Equals(LastNetActivityRotation, 1.0f);
+		LastNetActivityRotation = Rotation;
+
+		AdaptiveNetUpdate.Update(this, bActive);
+	}
+}
+
+void ATPSCharacter::UpdateForLocalControl()
+{
+	// Bots are locally controlled on listen servers but still need scaling like any remote character
+	const bool bLocallyControlled = IsLocallyControlled() && IsPlayerControlled();
+
+	// Only the local player's camera is ever viewed, remote cameras would still update their transforms and post process
+	if (FollowCamera)
+	{
+		FollowCamera->SetActive(bLocallyControlled);
+	}
+
+	UTPSSignificanceManager* SignificanceManager = USignificanceManager::Get<UTPSSignificanceManager>(GetWorld());
+	if (!SignificanceManager)
+	{
+		return;
+	}
+
+	if (!bLocallyControlled && !SignificanceRegistered)
+	{
+		SignificanceManager->RegisterCharacter(this);
+		SignificanceRegistered = true;
+	}
+	else if (bLocallyControlled && SignificanceRegistered)
+	{
+		SignificanceManager->UnregisterCharacter(this);
+		SignificanceRegistered = false;
+	}
 }
 
 UAbilitySystemComponent* ATPSCharacter::GetAbilitySystemComponent() const
@@ -181,6 +351,7 @@ float ATPSCharacter::GetHealth() const
 
 void ATPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
+#if !UE_SERVER
 	// Add Input Mapping Context
 	if (APlayerController* PlayerController = Cast<APlayerController>(GetController()))
 	{
@@ -189,6 +360,7 @@ void ATPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 			Subsystem->AddMappingContext(DefaultMappingContext, 0);
 		}
 	}
+#endif // !UE_SERVER
 	
 	// Set up action bindings
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent)) {
@@ -209,11 +381,13 @@ void ATPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 		EnhancedInputComponent->BindAction(ScopeAction, ETriggerEvent::Started, this, &ATPSCharacter::Scope);
 		EnhancedInputComponent->BindAction(ScopeAction, ETriggerEvent::Completed, this, &ATPSCharacter::StopScope);
 
-		// Moving
+		// Moving, Completed passes a zero value so input recordings see the stick being released
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &ATPSCharacter::Move);
+		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Completed, this, &ATPSCharacter::Move);
 
 		// Looking
 		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &ATPSCharacter::Look);
+		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Completed, this, &ATPSCharacter::Look);
 	}
 	else
 	{
@@ -225,6 +399,10 @@ void ATPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 
 void ATPSCharacter::Move(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::Move, Value.Get<FVector2D>());
+
 	// input is a Vector2D
 	FVector2D MovementVector = Value.Get<FVector2D>();
 
@@ -248,6 +426,10 @@ void ATPSCharacter::Move(const FInputActionValue& Value)
 
 void ATPSCharacter::Look(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::Look, Value.Get<FVector2D>());
+
 	// input is a Vector2D
 	FVector2D LookAxisVector = Value.Get<FVector2D>();
 
@@ -259,6 +441,45 @@ void ATPSCharacter::Look(const FInputActionValue& Value)
 	}
 }
 
+void ATPSCharacter::RecordInput(ETPSRecordedInput Input, const FVector2D& Value)
+{
+	if (ATPSPlayerController* PlayerController = GetController<ATPSPlayerController>())
+	{
+		PlayerController->RecordInput(Input, Value);
+	}
+}
+
+void ATPSCharacter::ReplayInput(ETPSRecordedInput Input, const FVector2D& Value)
+{
+	switch (Input)
+	{
+	case ETPSRecordedInput::Move:
+		Move(FInputActionValue(Value));
+		break;
+	case ETPSRecordedInput::Look:
+		Look(FInputActionValue(Value));
+		break;
+	case ETPSRecordedInput::Fire:
+		Fire(FInputActionValue(true));
+		break;
+	case ETPSRecordedInput::StopFire:
+		StopFire(FInputActionValue(false));
+		break;
+	case ETPSRecordedInput::Scope:
+		Scope(FInputActionValue(true));
+		break;
+	case ETPSRecordedInput::StopScope:
+		StopScope(FInputActionValue(false));
+		break;
+	case ETPSRecordedInput::Sprint:
+		Sprint(FInputActionValue(true));
+		break;
+	case ETPSRecordedInput::StopSprint:
+		StopSprint(FInputActionValue(false));
+		break;
+	}
+}
+
 void ATPSCharacter::SendAbilityLocalInput(const FInputActionValue& Value, int32 AbilityID)
 {
 	if (!AbilitySystemComponent.IsValid())
@@ -278,6 +499,10 @@ void ATPSCharacter::SendAbilityLocalInput(const FInputActionValue& Value, int32
 
 void ATPSCharacter::Sprint(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::Sprint);
+
 	if (!IsAlive())
 	{
 		return;
@@ -288,6 +513,10 @@ void ATPSCharacter::Sprint(const FInputActionValue& Value)
 
 void ATPSCharacter::StopSprint(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::StopSprint);
+
 	if (!IsAlive())
 	{
 		return;
@@ -298,6 +527,10 @@ void ATPSCharacter::StopSprint(const FInputActionValue& Value)
 
 void ATPSCharacter::Fire(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::Fire);
+
 	if (!IsAlive())
 	{
 		return;
@@ -308,6 +541,10 @@ void ATPSCharacter::Fire(const FInputActionValue& Value)
 
 void ATPSCharacter::StopFire(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::StopFire);
+
 	if (!IsAlive())
 	{
 		return;
@@ -318,6 +555,10 @@ void ATPSCharacter::StopFire(const FInputActionValue& Value)
 
 void ATPSCharacter::Scope(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::Scope);
+
 	if (!IsAlive())
 	{
 		return;
@@ -328,6 +569,10 @@ void ATPSCharacter::Scope(const FInputActionValue& Value)
 
 void ATPSCharacter::StopScope(const FInputActionValue& Value)
 {
+	TPS_SCOPE_CYCLE_COUNTER(Input);
+
+	RecordInput(ETPSRecordedInput::StopScope);
+
 	if (!IsAlive())
 	{
 		return;
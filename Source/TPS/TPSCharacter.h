@@ -6,6 +6,8 @@
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
 #include "AbilitySystemInterface.h"
+#include "TPSInputRecording.h"
+#include "Net/TPSAdaptiveNetUpdate.h"
 #include "TPSCharacter.generated.h"
 
 class USpringArmComponent;
@@ -89,10 +91,35 @@ private:
 
 	virtual void InitializeAttributes(class ATPSPlayerState* PS);
 
+	// Points the ASC at this character unless it already is. Returns false when there was nothing to do
+	bool InitAbilityActorInfo(class ATPSPlayerState* PS);
+
+	// Records time-to-ready once the ASC, attributes and, for the local player, input are all set up
+	void CheckAbilitySystemReady();
+
+	// Player state whose attributes were initialized for this character, OnRep_PlayerState can fire again for the same one
+	TWeakObjectPtr<class ATPSPlayerState> AttributesInitializedFor;
+
+	double AbilitySystemInitStartTime = 0.0;
+
+	bool AbilitySystemReady = false;
+
+	bool SignificanceRegistered = false;
+
+	// Remote characters are scaled by the significance manager and don't need an active camera
+	void UpdateForLocalControl();
+
+	// Rotation at the last adaptive net update check, turning in place counts as activity
+	FRotator LastNetActivityRotation = FRotator::ZeroRotator;
+
 protected:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ability")
 	TSubclassOf<class UGameplayEffect> DefaultAttributes;
 
+	// Full rate while moving or turning, decaying toward a floor while the character stands still
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	FTPSAdaptiveNetUpdate AdaptiveNetUpdate;
+
 	/** Called for movement input */
 	void Move(const FInputActionValue& Value);
 
@@ -110,6 +137,9 @@ protected:
 
 	void Scope(const FInputActionValue& Value);
 	void StopScope(const FInputActionValue& Value);
+
+	// Hands the input to the player controller when it is recording
+	void RecordInput(ETPSRecordedInput Input, const FVector2D& Value = FVector2D::ZeroVector);
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
@@ -117,17 +147,28 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void NotifyControllerChanged() override;
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
 public:
 
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
-	/** Returns FollowCamera subobject **/
+	/** Returns FollowCamera subobject, inactive in server builds **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 
 	float GetHealth() const;
 
+	// Feeds a recorded input through the same handler the input action would call
+	void ReplayInput(ETPSRecordedInput Input, const FVector2D& Value);
+
 
 };
 
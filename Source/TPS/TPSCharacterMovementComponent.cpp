@@ -3,6 +3,9 @@
 
 #include "TPSCharacterMovementComponent.h"
 #include "TPSCharacter.h"
+#include "TPSStats.h"
+#include "Diagnostics/TPSServerMetricsSubsystem.h"
+#include "Net/TPSCheatValidation.h"
 
 UTPSCharacterMovementComponent::UTPSCharacterMovementComponent()
 {
@@ -49,6 +52,58 @@ void UTPSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
 	RequestToStartADS = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
 }
 
+void UTPSCharacterMovementComponent::SendClientAdjustment()
+{
+	// A pending adjustment that does not ack a good move is a correction the client has to replay from
+	const FNetworkPredictionData_Server_Character* ServerData = HasPredictionData_Server() ? GetPredictionData_Server_Character() : nullptr;
+	const bool bCorrection = ServerData && ServerData->PendingAdjustment.TimeStamp > 0.0f && !ServerData->PendingAdjustment.bAckGoodMove;
+
+	Super::SendClientAdjustment();
+
+	if (bCorrection)
+	{
+		UTPSServerMetricsSubsystem::NotifyMovementCorrection(GetWorld());
+	}
+}
+
+void UTPSCharacterMovementComponent::PerformMovement(float DeltaTime)
+{
+	// Covers local ticks, client replays after a correction and moves the server runs for each client
+	TPS_SCOPE_CYCLE_COUNTER(Movement);
+
+	Super::PerformMovement(DeltaTime);
+}
+
+void UTPSCharacterMovementComponent::ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData)
+{
+	Super::ServerMove_PerformMovement(MoveData);
+
+	// Rejected and old moves do not advance the client clock
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	if (!CharacterOwner || !ServerData || ServerData->CurrentClientTimeStamp != MoveData.TimeStamp)
+	{
+		return;
+	}
+
+	// Falling, root motion and locations relative to a moving base are not limited by GetMaxSpeed, 0 skips the distance check
+	const float MaxSpeed = IsFalling() || HasAnimRootMotion() || MoveData.MovementBase ? 0.0f : GetMaxSpeed();
+
+	// The client's own location is checked rather than the server's velocity, which GetMaxSpeed already capped
+	const FRotator AimDelta = bHasLastServerMove ? (MoveData.ControlRotation - LastServerMoveControlRotation).GetNormalized() : FRotator::ZeroRotator;
+	const float ClientMoveDistance = bHasLastServerMove ? FVector::Dist2D(MoveData.Location, LastServerMoveLocation) : 0.0f;
+
+	// Slowing down from a sprint still covers sprint distance on the first walking move
+	const float AllowedSpeed = MaxSpeed > 0.0f && LastServerMoveMaxSpeed > 0.0f ? FMath::Max(MaxSpeed, LastServerMoveMaxSpeed) : 0.0f;
+
+	LastServerMoveControlRotation = MoveData.ControlRotation;
+	LastServerMoveLocation = MoveData.Location;
+	LastServerMoveMaxSpeed = MaxSpeed;
+	bHasLastServerMove = true;
+
+	UTPSCheatValidationSubsystem::ReportMove(GetWorld(), CharacterOwner->GetPlayerState(), MoveData.TimeStamp, ClientMoveDistance, AllowedSpeed,
+		FMath::Abs(AimDelta.Yaw) + FMath::Abs(AimDelta.Pitch));
+}
+
 FNetworkPredictionData_Client* UTPSCharacterMovementComponent::GetPredictionData_Client() const
 {
 	check(PawnOwner != NULL);
@@ -68,6 +68,7 @@ public:
 	virtual float GetMaxSpeed() const override;
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
 	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void SendClientAdjustment() override;
 
 	// Sprint
 	UFUNCTION(BlueprintCallable, Category = "Sprint")
@@ -80,5 +81,20 @@ public:
 	void StartAimDownSights();
 	UFUNCTION(BlueprintCallable, Category = "Aim Down Sights")
 	void StopAimDownSights();
-	
+
+protected:
+	virtual void PerformMovement(float DeltaTime) override;
+
+	// Hands every accepted client move to the server cheat validation
+	virtual void ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData) override;
+
+private:
+	// Previous accepted client move, for the aim and distance the client claims between moves
+	FRotator LastServerMoveControlRotation = FRotator::ZeroRotator;
+
+	FVector LastServerMoveLocation = FVector::ZeroVector;
+
+	float LastServerMoveMaxSpeed = 0.0f;
+
+	bool bHasLastServerMove = false;
 };
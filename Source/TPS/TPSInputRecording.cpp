@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSInputRecording.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace TPSInputRecording
+{
+	// Bumped whenever FTPSRecordedInputEvent serialization changes
+	static constexpr int32 FileVersion = 2;
+}
+
+FString FTPSInputRecording::ResolvePath(const FString& FileName)
+{
+	if (!FPaths::IsRelative(FileName))
+	{
+		return FileName;
+	}
+
+	const FString WithExtension = FPaths::GetExtension(FileName).IsEmpty() ? FileName + TEXT(".tpsinput") : FileName;
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputRecordings"), WithExtension);
+}
+
+bool FTPSInputRecording::SaveToFile(const FString& FileName) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	int32 Version = TPSInputRecording::FileVersion;
+	Writer << Version;
+
+	// Same layout as serializing the array directly, so LoadFromFile can read it back in one go
+	int32 NumEvents = Events.Num();
+	Writer << NumEvents;
+	for (FTPSRecordedInputEvent Event : Events)
+	{
+		Writer << Event;
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *ResolvePath(FileName));
+}
+
+bool FTPSInputRecording::LoadFromFile(const FString& FileName)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *ResolvePath(FileName)))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != TPSInputRecording::FileVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() %s has version %d, expected %d"), *FString(__FUNCTION__), *FileName, Version, TPSInputRecording::FileVersion);
+		return false;
+	}
+
+	Reader << Events;
+	return !Reader.IsError();
+}
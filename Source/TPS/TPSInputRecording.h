@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Character inputs that can be recorded and replayed
+enum class ETPSRecordedInput : uint8
+{
+	Move,
+	Look,
+	Fire,
+	StopFire,
+	Scope,
+	StopScope,
+	Sprint,
+	StopSprint,
+};
+
+struct FTPSRecordedInputEvent
+{
+	// Seconds since the recording started
+	float Time = 0.0f;
+
+	ETPSRecordedInput Input = ETPSRecordedInput::Move;
+
+	// Axis value for Move, axis value per second for Look, unused for button inputs.
+	// Both are held until the next event of the same input so replays are independent of frame rate
+	FVector2D Value = FVector2D::ZeroVector;
+
+	friend FArchive& operator<<(FArchive& Ar, FTPSRecordedInputEvent& Event)
+	{
+		uint8 Input = static_cast<uint8>(Event.Input);
+		Ar << Event.Time << Input << Event.Value;
+		Event.Input = static_cast<ETPSRecordedInput>(Input);
+		return Ar;
+	}
+};
+
+/**
+ * A stream of character inputs with timestamps, recorded from a real player and replayed by headless clients
+ * so the server sees realistic move, look, fire, scope and sprint traffic through the normal prediction path.
+ */
+class TPS_API FTPSInputRecording
+{
+public:
+	TArray<FTPSRecordedInputEvent> Events;
+
+	// Relative names resolve to Saved/InputRecordings/<Name>.tpsinput
+	static FString ResolvePath(const FString& FileName);
+
+	bool SaveToFile(const FString& FileName) const;
+
+	bool LoadFromFile(const FString& FileName);
+
+	float GetDuration() const { return Events.Num() > 0 ? Events.Last().Time : 0.0f; }
+};
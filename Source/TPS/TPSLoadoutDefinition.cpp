@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TPSLoadoutDefinition.h"
+#include "TPSAssetManager.h"
+
+FPrimaryAssetId UTPSLoadoutDefinition::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(UTPSAssetManager::LoadoutType, GetFName());
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TPSLoadoutDefinition.generated.h"
+
+class UTPSGameplayAbility;
+class UGameplayEffect;
+
+/**
+ * Everything a loadout can use during a match. All references are soft and grouped in the Loadout bundle,
+ * UTPSAssetManager loads them asynchronously during map load.
+ */
+UCLASS(BlueprintType)
+class TPS_API UTPSLoadoutDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Weapon blueprints (BP_BaseWeapon children)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout", meta = (AssetBundles = "Loadout"))
+	TArray<TSoftClassPtr<AActor>> Weapons;
+
+	// Abilities granted with this loadout (GA_*)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout", meta = (AssetBundles = "Loadout"))
+	TArray<TSoftClassPtr<UTPSGameplayAbility>> Abilities;
+
+	// Gameplay effects applied by the abilities and weapons (GE_*)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout", meta = (AssetBundles = "Loadout"))
+	TArray<TSoftClassPtr<UGameplayEffect>> Effects;
+
+	// FX, sounds and montages spawned by the loadout that aren't hard referenced by the weapons
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout", meta = (AssetBundles = "Loadout"))
+	TArray<TSoftObjectPtr<UObject>> Cosmetics;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+};
@@ -2,7 +2,181 @@
 
 
 #include "TPSPlayerController.h"
+#include "TPSCharacter.h"
+#include "Significance/TPSSignificanceManager.h"
+#include "Camera/TPSPlayerCameraManager.h"
+#include "Combat/TPSHitPredictionComponent.h"
 
+ATPSPlayerController::ATPSPlayerController()
+{
+#if !UE_SERVER
+	PlayerCameraManagerClass = ATPSPlayerCameraManager::StaticClass();
+#endif
 
+	HitPrediction = CreateDefaultSubobject<UTPSHitPredictionComponent>(TEXT("HitPrediction"));
 
+	// Every player streams the world around it, on the server too with wp.Runtime.EnableServerStreaming
+	bEnableStreamingSource = true;
+	bStreamingSourceShouldActivate = true;
+}
 
+void ATPSPlayerController::GetStreamingSourceShapes(TArray<FStreamingSourceShape>& OutShapes) const
+{
+	// The server needs collision around players, not everything a client can see
+	if (ServerStreamingRadius > 0.0f && GetNetMode() == NM_DedicatedServer)
+	{
+		FStreamingSourceShape& Shape = OutShapes.AddDefaulted_GetRef();
+		Shape.bUseGridLoadingRange = false;
+		Shape.Radius = ServerStreamingRadius;
+		return;
+	}
+
+	Super::GetStreamingSourceShapes(OutShapes);
+}
+
+void ATPSPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Headless load clients: -TPSReplayInput=<File> [-TPSReplayLoop]
+	FString ReplayFile;
+	if (IsLocalController() && FParse::Value(FCommandLine::Get(), TEXT("-TPSReplayInput="), ReplayFile))
+	{
+		TPSReplayInput(ReplayFile, FParse::Param(FCommandLine::Get(), TEXT("TPSReplayLoop")));
+	}
+}
+
+void ATPSPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	// The first local player refreshes significance for every local view in the world
+	if (GetWorld()->GetFirstPlayerController() == this)
+	{
+		if (UTPSSignificanceManager* SignificanceManager = USignificanceManager::Get<UTPSSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->UpdateFromLocalPlayers();
+		}
+	}
+
+	if (bRecordingInput || bReplayingInput)
+	{
+		InputStreamTime += DeltaTime;
+	}
+
+	if (bReplayingInput)
+	{
+		TickInputReplay(DeltaTime);
+	}
+}
+
+void ATPSPlayerController::TPSRecordInput()
+{
+	InputRecording.Events.Reset();
+	InputStreamTime = 0.0f;
+	bReplayingInput = false;
+	bRecordingInput = true;
+}
+
+void ATPSPlayerController::TPSStopRecordInput(const FString& FileName)
+{
+	if (!bRecordingInput)
+	{
+		return;
+	}
+
+	bRecordingInput = false;
+	if (!InputRecording.SaveToFile(FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Failed to write %s"), *FString(__FUNCTION__), *FTPSInputRecording::ResolvePath(FileName));
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s() Wrote %d events (%.1fs) to %s"), *FString(__FUNCTION__), InputRecording.Events.Num(), InputRecording.GetDuration(), *FTPSInputRecording::ResolvePath(FileName));
+}
+
+void ATPSPlayerController::TPSReplayInput(const FString& FileName, bool bLoop)
+{
+	if (!InputRecording.LoadFromFile(FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Failed to read %s"), *FString(__FUNCTION__), *FTPSInputRecording::ResolvePath(FileName));
+		return;
+	}
+
+	InputStreamTime = 0.0f;
+	NextReplayEvent = 0;
+	ReplayMoveValue = FVector2D::ZeroVector;
+	ReplayLookRate = FVector2D::ZeroVector;
+	bRecordingInput = false;
+	bLoopInputReplay = bLoop;
+	bReplayingInput = InputRecording.Events.Num() > 0;
+}
+
+void ATPSPlayerController::RecordInput(ETPSRecordedInput Input, const FVector2D& Value)
+{
+	if (!bRecordingInput)
+	{
+		return;
+	}
+
+	FTPSRecordedInputEvent& Event = InputRecording.Events.AddDefaulted_GetRef();
+	Event.Time = InputStreamTime;
+	Event.Input = Input;
+	Event.Value = Value;
+
+	// Look is a per-frame delta, stored as a rate so a replay at another frame rate turns just as far
+	if (Input == ETPSRecordedInput::Look)
+	{
+		const float DeltaSeconds = GetWorld()->GetDeltaSeconds();
+		Event.Value = DeltaSeconds > 0.0f ? Value / DeltaSeconds : FVector2D::ZeroVector;
+	}
+}
+
+void ATPSPlayerController::TickInputReplay(float DeltaTime)
+{
+	ATPSCharacter* ReplayCharacter = GetPawn<ATPSCharacter>();
+	if (!ReplayCharacter)
+	{
+		// Wait for a pawn, e.g. after death, without skipping ahead in the stream
+		InputStreamTime -= DeltaTime;
+		return;
+	}
+
+	const TArray<FTPSRecordedInputEvent>& Events = InputRecording.Events;
+	while (NextReplayEvent < Events.Num() && Events[NextReplayEvent].Time <= InputStreamTime)
+	{
+		const FTPSRecordedInputEvent& Event = Events[NextReplayEvent];
+		switch (Event.Input)
+		{
+		case ETPSRecordedInput::Move:
+			ReplayMoveValue = Event.Value;
+			break;
+		case ETPSRecordedInput::Look:
+			ReplayLookRate = Event.Value;
+			break;
+		default:
+			ReplayCharacter->ReplayInput(Event.Input, Event.Value);
+			break;
+		}
+		++NextReplayEvent;
+	}
+
+	// Recorded frames rarely line up with replay frames, so axes are applied every frame rather than per event
+	if (!ReplayMoveValue.IsZero())
+	{
+		ReplayCharacter->ReplayInput(ETPSRecordedInput::Move, ReplayMoveValue);
+	}
+	if (!ReplayLookRate.IsZero())
+	{
+		ReplayCharacter->ReplayInput(ETPSRecordedInput::Look, ReplayLookRate * DeltaTime);
+	}
+
+	if (NextReplayEvent >= Events.Num())
+	{
+		NextReplayEvent = 0;
+		InputStreamTime = 0.0f;
+		ReplayMoveValue = FVector2D::ZeroVector;
+		ReplayLookRate = FVector2D::ZeroVector;
+		bReplayingInput = bLoopInputReplay;
+	}
+}
@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "TPSInputRecording.h"
 #include "TPSPlayerController.generated.h"
 
+class UTPSHitPredictionComponent;
+
 /**
  * 
  */
@@ -14,4 +17,57 @@ class TPS_API ATPSPlayerController : public APlayerController
 {
 	GENERATED_BODY()
 
+public:
+	ATPSPlayerController();
+
+	virtual void PlayerTick(float DeltaTime) override;
+
+	// Starts recording Move/Look/Fire/Scope/Sprint input of the possessed character
+	UFUNCTION(Exec)
+	void TPSRecordInput();
+
+	// Stops recording and writes the stream to Saved/InputRecordings/<FileName>.tpsinput
+	UFUNCTION(Exec)
+	void TPSStopRecordInput(const FString& FileName);
+
+	// Replays a recorded stream through the character's input handlers, as if the player was pressing the keys
+	UFUNCTION(Exec)
+	void TPSReplayInput(const FString& FileName, bool bLoop = false);
+
+	void RecordInput(ETPSRecordedInput Input, const FVector2D& Value);
+
+	UTPSHitPredictionComponent* GetHitPrediction() const { return HitPrediction; }
+
+	// World Partition cells a dedicated server keeps loaded around each player, 0 uses the grid loading range like clients
+	UPROPERTY(EditDefaultsOnly, Category = "WorldPartition")
+	float ServerStreamingRadius = 10000.0f;
+
+	virtual void GetStreamingSourceShapes(TArray<FStreamingSourceShape>& OutShapes) const override;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	// Predicted hit markers and health bars for whatever this player shoots
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UTPSHitPredictionComponent> HitPrediction;
+
+	void TickInputReplay(float DeltaTime);
+
+	FTPSInputRecording InputRecording;
+
+	bool bRecordingInput = false;
+
+	bool bReplayingInput = false;
+
+	bool bLoopInputReplay = false;
+
+	float InputStreamTime = 0.0f;
+
+	int32 NextReplayEvent = 0;
+
+	// Move and Look are held between their events and applied every replay frame
+	FVector2D ReplayMoveValue = FVector2D::ZeroVector;
+
+	FVector2D ReplayLookRate = FVector2D::ZeroVector;
 };
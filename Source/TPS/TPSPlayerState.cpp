@@ -3,6 +3,14 @@
 
 #include "TPSPlayerState.h"
 #include "AbilitySystemComponent.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
+
+namespace TPSPlayerState
+{
+	// How often an idle player state lowers its net update frequency
+	static constexpr float NetFrequencyUpdateInterval = 0.25f;
+}
 
 ATPSPlayerState::ATPSPlayerState()
 {
@@ -13,7 +21,54 @@ ATPSPlayerState::ATPSPlayerState()
 
 	AttributeSet = CreateDefaultSubobject<UCharacterAttributeSet>(TEXT("AttributeSet"));
 
-	NetUpdateFrequency = 100.0f;
+	NetUpdateFrequency = AdaptiveNetUpdate.MaxFrequency;
+}
+
+void ATPSPlayerState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	AbilitySystemComponent->OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &ATPSPlayerState::OnGameplayEffectApplied);
+	AbilitySystemComponent->RegisterGenericGameplayTagEvent().AddUObject(this, &ATPSPlayerState::OnGameplayTagChanged);
+	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UCharacterAttributeSet::GetHealthAttribute()).AddUObject(this, &ATPSPlayerState::OnHealthChanged);
+
+	GetWorldTimerManager().SetTimer(NetFrequencyTimerHandle, this, &ATPSPlayerState::UpdateNetFrequency, TPSPlayerState::NetFrequencyUpdateInterval, true);
+}
+
+void ATPSPlayerState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (HasAuthority())
+	{
+		GetWorldTimerManager().ClearTimer(NetFrequencyTimerHandle);
+		AdaptiveNetUpdate.Reset(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATPSPlayerState::OnGameplayEffectApplied(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	AdaptiveNetUpdate.Bump(this);
+}
+
+void ATPSPlayerState::OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	AdaptiveNetUpdate.Bump(this);
+}
+
+void ATPSPlayerState::OnHealthChanged(const FOnAttributeChangeData& Data)
+{
+	AdaptiveNetUpdate.Bump(this);
+}
+
+void ATPSPlayerState::UpdateNetFrequency()
+{
+	AdaptiveNetUpdate.Update(this);
 }
 
 UAbilitySystemComponent* ATPSPlayerState::GetAbilitySystemComponent() const
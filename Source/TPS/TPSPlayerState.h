@@ -6,6 +6,8 @@
 #include "GameFramework/PlayerState.h"
 #include "AbilitySystemInterface.h"
 #include "CharacterAttributeSet.h"
+#include "GameplayEffectTypes.h"
+#include "Net/TPSAdaptiveNetUpdate.h"
 #include "TPSPlayerState.generated.h"
 
 /**
@@ -24,6 +26,25 @@ protected:
 	UPROPERTY(Transient)
 	UCharacterAttributeSet* AttributeSet;
 
+	// Full rate while effects, tags or health change, decaying toward a floor while the player is idle or dead
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	FTPSAdaptiveNetUpdate AdaptiveNetUpdate;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void OnGameplayEffectApplied(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+
+	void OnGameplayTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	void OnHealthChanged(const FOnAttributeChangeData& Data);
+
+	void UpdateNetFrequency();
+
+	FTimerHandle NetFrequencyTimerHandle;
+
 public:
 	ATPSPlayerState();
 
@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// "stat TPS" in game, the TPS category in CSV captures and the TPS channel in Unreal Insights (-trace=cpu,TPS)
+DECLARE_STATS_GROUP(TEXT("TPS"), STATGROUP_TPS, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Input"), STAT_TPS_Input, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ASC Init"), STAT_TPS_ASCInit, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Attributes"), STAT_TPS_InitializeAttributes, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Add Abilities"), STAT_TPS_AddAbilities, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movement"), STAT_TPS_Movement, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Broadcast"), STAT_TPS_AttributeBroadcast, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Activation"), STAT_TPS_AbilityActivation, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"), STAT_TPS_Significance, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bots"), STAT_TPS_Bots, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cue Flush"), STAT_TPS_CueFlush, STATGROUP_TPS, TPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Metrics"), STAT_TPS_ServerMetrics, STATGROUP_TPS, TPS_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Damage applications"), STAT_TPS_DamageApplications, STATGROUP_TPS, TPS_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last ASC time to ready (ms)"), STAT_TPS_ASCTimeToReadyMs, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Redundant ASC inits skipped"), STAT_TPS_ASCInitsSkipped, STATGROUP_TPS, TPS_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Net update Hz saved"), STAT_TPS_NetHzSaved, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Predicted hits"), STAT_TPS_PredictedHits, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Confirmed hits"), STAT_TPS_ConfirmedHits, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rolled back hits"), STAT_TPS_RolledBackHits, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cheat verdicts"), STAT_TPS_CheatVerdicts, STATGROUP_TPS, TPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("First-use loads"), STAT_TPS_FirstUseLoads, STATGROUP_TPS, TPS_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(TPS_API, TPS);
+
+UE_TRACE_CHANNEL_EXTERN(TPSChannel, TPS_API);
+
+// Times the enclosing scope in all three profilers at once. StatName must have a matching STAT_TPS_<StatName>
+#define TPS_SCOPE_CYCLE_COUNTER(StatName) \
+	SCOPE_CYCLE_COUNTER(STAT_TPS_##StatName); \
+	CSV_SCOPED_TIMING_STAT(TPS, StatName); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("TPS::" #StatName, TPSChannel)
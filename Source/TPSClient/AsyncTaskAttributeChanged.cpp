@@ -2,6 +2,7 @@
 
 
 #include "AsyncTaskAttributeChanged.h"
+#include "TPSStats.h"
 
 UAsyncTaskAttributeChanged* UAsyncTaskAttributeChanged::ListenForAttributeChange(UAbilitySystemComponent* AbilitySystemComponent, FGameplayAttribute Attribute)
 {
@@ -58,5 +59,7 @@ void UAsyncTaskAttributeChanged::EndTask()
 
 void UAsyncTaskAttributeChanged::AttributeChanged(const FOnAttributeChangeData& Data)
 {
+	TPS_SCOPE_CYCLE_COUNTER(AttributeBroadcast);
+
 	OnAttributeChanged.Broadcast(Data.Attribute, Data.NewValue, Data.OldValue);
 }